@@ -2,8 +2,31 @@
 #include <stdlib.h>
 #include <time.h>
 #include <limits.h>
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <getopt.h>
+#include <pthread.h>
 
-#define MAX_FUTURE_ACCESSES 5000    // 최대 미래 페이지 액세스 수
+#define GENERATED_ACCESS_COUNT 5000    // input.in 자동 생성 시 가상주소 개수
+
+// 바이너리 트레이스 형식
+// 헤더(24바이트, 리틀 엔디언): 매직 "PGTR", 버전, 가상주소 길이(bit), log2(페이지 크기), 플래그,
+//                              블록당 최대 레코드 수(4), 전체 레코드 수(8), 예약(4)
+// 블록: 레코드 수(4), 페이로드 크기(4), 페이로드 = 페이지 번호 차이의 zig-zag varint 나열
+// 각 블록의 첫 레코드는 페이지 번호 0을 기준으로 한 차이이므로 블록마다 독립적으로 디코딩 가능
+// PID 플래그가 있으면 각 레코드의 페이지 번호 차이 앞에 PID를 varint로 기록
+// WRITE 플래그가 있으면 zig-zag 값을 한 비트 올리고 최하위 비트에 쓰기 여부를 기록
+#define BINARY_TRACE_MAGIC "PGTR"
+#define BINARY_TRACE_VERSION 1
+#define BINARY_TRACE_HEADER_SIZE 24
+#define BINARY_TRACE_BLOCK_RECORDS 4096
+#define BINARY_TRACE_FLAG_PID 0x01      // 레코드마다 프로세스 ID가 기록된 트레이스
+#define BINARY_TRACE_FLAG_WRITE 0x02    // 레코드마다 읽기/쓰기 구분이 기록된 트레이스
 
 
 // 페이지 교체 알고리즘 종류
@@ -11,248 +34,4371 @@ typedef enum {
     OPTIMAL,
     FIFO,
     LRU,
-    SECOND_CHANCE
+    SECOND_CHANCE,
+    ENHANCED_SECOND_CHANCE, // (참조 비트, 더티 비트) 등급이 가장 낮은 페이지를 교체 (NRU)
+    ARC,            // Adaptive Replacement Cache
+    TWO_QUEUE,      // 2Q (A1in/A1out/Am)
+    CLOCK_PRO,
+    LFU             // 빈도 버킷을 이용한 O(1) LFU
 } Algorithm;
 
-// 가상주소 처리를 위한 페이지 테이블 엔트리
-typedef struct {
-    int valid;         // 유효한 페이지인지 여부
-    int frame;         // 물리 메모리의 프레임 번호
-    int reference_bit; // Second-Chance 알고리즘을 위한 참조 비트
-    int last_used;     // LRU 알고리즘을 위한 마지막 사용 시간
-} PageTableEntry;
+// 알고리즘 이름 (명령행 인자 및 출력 파일 확장자로 사용)
+const char* algorithm_names[] = { "opt", "fifo", "lru", "sc", "esc", "arc", "2q", "clockpro", "lfu" };
+#define ALGORITHM_COUNT 9
+
+// 가상주소 처리를 위한 페이지 테이블 엔트리 (비트 단위로 압축하여 4바이트)
+#define PTE_FRAME_BITS 28
+#define MAX_FRAMES (1 << PTE_FRAME_BITS)    // 엔트리에 기록할 수 있는 최대 프레임 수
+
+typedef struct {
+    unsigned int frame : PTE_FRAME_BITS;    // 물리 메모리의 프레임 번호
+    unsigned int valid : 1;                 // 유효한 페이지인지 여부
+    unsigned int reference_bit : 1;         // Second-Chance 알고리즘을 위한 참조 비트
+    unsigned int dirty : 1;                 // 적재된 뒤 쓰기가 있었는지 여부 (쫓겨날 때 디스크에 다시 써야 함)
+    unsigned int prefetched : 1;            // 적재된 페이지: 프리페치로 적재된 뒤 아직 참조되지 않음
+                                            // 쫓겨난 페이지: 프리페치할 자리를 만들려고 쫓겨남 (다시 폴트가 나면 오염으로 집계)
+} PageTableEntry;
+
+// 다단계(radix) 페이지 테이블
+// 가상 페이지 번호를 상위 비트부터 PT_LEVEL_BITS씩 잘라 각 단계의 인덱스로 사용하고,
+// 실제로 참조된 페이지가 있는 경로의 노드만 할당하므로 메모리 사용량이 가상주소 공간이 아닌 참조한 페이지 수에 비례함
+// (4KB 페이지의 48bits 가상주소는 x86-64와 같은 4단계 테이블이 됨)
+#define PT_LEVEL_BITS 9
+#define PT_LEVEL_ENTRIES (1 << PT_LEVEL_BITS)
+
+typedef struct {
+    int levels;             // 단계 수
+    int top_bits;           // 최상위 단계의 인덱스 비트 수
+    void* root;             // 최상위 노드 (단계가 1이면 엔트리 배열)
+    long node_count;        // 할당된 노드 수
+    size_t memory_bytes;    // 할당된 노드의 전체 크기
+} PageTable;
+
+static void* page_table_alloc_node(PageTable* table, int entries, size_t entry_size) {
+    table->node_count++;
+    table->memory_bytes += entries * entry_size;
+    return calloc(entries, entry_size);
+}
+
+// 가상 페이지 번호의 비트 수로 페이지 테이블을 초기화하는 함수
+void page_table_init(PageTable* table, int vpn_bits) {
+    memset(table, 0, sizeof(PageTable));
+    table->levels = vpn_bits <= PT_LEVEL_BITS ? 1 : (vpn_bits + PT_LEVEL_BITS - 1) / PT_LEVEL_BITS;
+    table->top_bits = vpn_bits - (table->levels - 1) * PT_LEVEL_BITS;
+    if (table->levels == 1) {
+        table->root = page_table_alloc_node(table, 1 << table->top_bits, sizeof(PageTableEntry));
+    }
+    else {
+        table->root = page_table_alloc_node(table, 1 << table->top_bits, sizeof(void*));
+    }
+}
+
+// 페이지 번호에 해당하는 엔트리를 찾는 함수
+// 경로의 노드가 없으면 create가 1일 때만 할당하고, 0이면 NULL 반환 (아직 참조된 적 없는 유효하지 않은 페이지)
+PageTableEntry* page_table_lookup(PageTable* table, unsigned long page_number, int create) {
+    void* node = table->root;
+    int shift = (table->levels - 1) * PT_LEVEL_BITS;
+
+    for (int level = 0; level < table->levels - 1; level++) {
+        void** slot = &((void**)node)[(page_number >> shift) & ((level == 0 ? 1UL << table->top_bits : PT_LEVEL_ENTRIES) - 1)];
+        if (*slot == NULL) {
+            if (!create) {
+                return NULL;
+            }
+            if (level == table->levels - 2) {
+                *slot = page_table_alloc_node(table, PT_LEVEL_ENTRIES, sizeof(PageTableEntry));
+            }
+            else {
+                *slot = page_table_alloc_node(table, PT_LEVEL_ENTRIES, sizeof(void*));
+            }
+        }
+        node = *slot;
+        shift -= PT_LEVEL_BITS;
+    }
+
+    unsigned long mask = (table->levels == 1 ? 1UL << table->top_bits : PT_LEVEL_ENTRIES) - 1;
+    return &((PageTableEntry*)node)[page_number & mask];
+}
+
+static void page_table_free_node(void* node, int level, int levels, int entries) {
+    if (node == NULL) {
+        return;
+    }
+    if (level < levels - 1) {
+        for (int i = 0; i < entries; i++) {
+            page_table_free_node(((void**)node)[i], level + 1, levels, PT_LEVEL_ENTRIES);
+        }
+    }
+    free(node);
+}
+
+void page_table_free(PageTable* table) {
+    page_table_free_node(table->root, 0, table->levels, 1 << table->top_bits);
+    memset(table, 0, sizeof(PageTable));
+}
+
+// 페이지 번호 → 값 해시 맵 (선형 탐사 방식의 오픈 어드레싱)
+// 가상주소 공간 전체 크기의 배열을 만들 수 없을 때 페이지별 정보를 저장하는 데 사용
+#define PAGE_MAP_EMPTY ULONG_MAX
+
+typedef struct {
+    unsigned long* keys;
+    long* values;
+    size_t capacity;    // 2의 거듭제곱
+    size_t count;
+} PageMap;
+
+static size_t page_map_slot(const PageMap* map, unsigned long key) {
+    return (size_t)((key * 0x9E3779B97F4A7C15UL) >> 17) & (map->capacity - 1);
+}
+
+void page_map_init(PageMap* map, size_t expected) {
+    map->capacity = 16;
+    while (map->capacity < expected * 2) {
+        map->capacity *= 2;
+    }
+    map->count = 0;
+    map->keys = malloc(map->capacity * sizeof(unsigned long));
+    map->values = malloc(map->capacity * sizeof(long));
+    for (size_t i = 0; i < map->capacity; i++) {
+        map->keys[i] = PAGE_MAP_EMPTY;
+    }
+}
+
+void page_map_free(PageMap* map) {
+    free(map->keys);
+    free(map->values);
+    memset(map, 0, sizeof(PageMap));
+}
+
+// 키의 값을 가리키는 포인터 반환 (없으면 NULL)
+long* page_map_find(const PageMap* map, unsigned long key) {
+    for (size_t i = page_map_slot(map, key);; i = (i + 1) & (map->capacity - 1)) {
+        if (map->keys[i] == key) {
+            return &map->values[i];
+        }
+        if (map->keys[i] == PAGE_MAP_EMPTY) {
+            return NULL;
+        }
+    }
+}
+
+static void page_map_grow(PageMap* map) {
+    PageMap grown;
+    grown.capacity = map->capacity * 2;
+    grown.count = 0;
+    grown.keys = malloc(grown.capacity * sizeof(unsigned long));
+    grown.values = malloc(grown.capacity * sizeof(long));
+    for (size_t i = 0; i < grown.capacity; i++) {
+        grown.keys[i] = PAGE_MAP_EMPTY;
+    }
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (map->keys[i] != PAGE_MAP_EMPTY) {
+            size_t j = page_map_slot(&grown, map->keys[i]);
+            while (grown.keys[j] != PAGE_MAP_EMPTY) {
+                j = (j + 1) & (grown.capacity - 1);
+            }
+            grown.keys[j] = map->keys[i];
+            grown.values[j] = map->values[i];
+            grown.count++;
+        }
+    }
+    page_map_free(map);
+    *map = grown;
+}
+
+// 키의 값을 가리키는 포인터 반환 (없으면 initial 값으로 새로 추가)
+long* page_map_insert(PageMap* map, unsigned long key, long initial) {
+    long* value = page_map_find(map, key);
+    if (value != NULL) {
+        return value;
+    }
+    if ((map->count + 1) * 4 > map->capacity * 3) {
+        page_map_grow(map);
+    }
+
+    size_t i = page_map_slot(map, key);
+    while (map->keys[i] != PAGE_MAP_EMPTY) {
+        i = (i + 1) & (map->capacity - 1);
+    }
+    map->keys[i] = key;
+    map->values[i] = initial;
+    map->count++;
+    return &map->values[i];
+}
+
+// 키를 삭제하는 함수 (뒤따르는 엔트리를 당겨 채우므로 삭제 표시가 필요 없음)
+void page_map_remove(PageMap* map, unsigned long key) {
+    size_t i = page_map_slot(map, key);
+    while (map->keys[i] != key) {
+        if (map->keys[i] == PAGE_MAP_EMPTY) {
+            return;
+        }
+        i = (i + 1) & (map->capacity - 1);
+    }
+
+    size_t hole = i;
+    for (size_t j = (i + 1) & (map->capacity - 1); map->keys[j] != PAGE_MAP_EMPTY; j = (j + 1) & (map->capacity - 1)) {
+        size_t home = page_map_slot(map, map->keys[j]);
+        // home이 (hole, j] 범위 밖이면 hole로 옮겨도 탐색 경로가 유지됨
+        if (((j - home) & (map->capacity - 1)) >= ((j - hole) & (map->capacity - 1))) {
+            map->keys[hole] = map->keys[j];
+            map->values[hole] = map->values[j];
+            hole = j;
+        }
+    }
+    map->keys[hole] = PAGE_MAP_EMPTY;
+    map->count--;
+}
+
+// TLB 모델
+// 집합 연관(set-associative) 구조이며 연관도가 0이면 완전 연관으로 동작
+// 기본 페이지 TLB와 2MB 단위의 huge page TLB를 함께 조회하고, 둘 다 없으면 페이지 테이블을 탐색(walk)한 뒤 채움
+#define TLB_HIT_CYCLES 1                // TLB 조회 비용 (사이클)
+#define DEFAULT_WALK_CYCLES 20          // 페이지 테이블 한 단계를 읽는 비용 (사이클)
+#define HUGE_PAGE_SHIFT 21              // huge page 크기 (2MB)
+
+typedef enum {
+    TLB_LRU,
+    TLB_FIFO
+} TlbPolicy;
+
+// TLB 설정 (entries가 0이면 TLB를 사용하지 않음)
+typedef struct {
+    int entries;            // 기본 페이지 TLB 엔트리 수
+    int ways;               // 연관도 (0이면 완전 연관)
+    TlbPolicy policy;
+    int huge_entries;       // huge page TLB 엔트리 수 (0이면 huge page를 사용하지 않음)
+    int walk_cycles;        // 페이지 테이블 단계당 비용 (사이클)
+} TlbConfig;
+
+#define TLB_INVALID ULONG_MAX
+
+typedef struct {
+    int sets;
+    int ways;
+    TlbPolicy policy;
+    unsigned long* tags;        // 페이지(또는 huge page) 번호, 비어 있으면 TLB_INVALID
+    unsigned long* stamps;      // LRU: 마지막 사용 시각, FIFO: 채운 시각
+    PageTableEntry** entries;   // 캐시된 페이지 테이블 엔트리 (히트 시 페이지 테이블 탐색 생략)
+    unsigned long clock;
+} Tlb;
+
+// TLB를 초기화하는 함수 (성공 시 0, 엔트리 수가 연관도로 나누어떨어지지 않으면 -1)
+int tlb_init(Tlb* tlb, int entries, int ways, TlbPolicy policy) {
+    memset(tlb, 0, sizeof(Tlb));
+    if (ways == 0) {
+        ways = entries;
+    }
+    if (entries <= 0 || ways <= 0 || entries % ways != 0) {
+        return -1;
+    }
+    tlb->sets = entries / ways;
+    tlb->ways = ways;
+    tlb->policy = policy;
+    tlb->tags = malloc(entries * sizeof(unsigned long));
+    tlb->stamps = calloc(entries, sizeof(unsigned long));
+    tlb->entries = calloc(entries, sizeof(PageTableEntry*));
+    for (int i = 0; i < entries; i++) {
+        tlb->tags[i] = TLB_INVALID;
+    }
+    return 0;
+}
+
+void tlb_free(Tlb* tlb) {
+    free(tlb->tags);
+    free(tlb->stamps);
+    free(tlb->entries);
+    memset(tlb, 0, sizeof(Tlb));
+}
+
+// 키가 있는 슬롯 번호 반환 (없으면 -1), LRU 정책이면 사용 시각 갱신
+int tlb_lookup(Tlb* tlb, unsigned long key) {
+    int base = (int)(key % tlb->sets) * tlb->ways;
+    for (int i = base; i < base + tlb->ways; i++) {
+        if (tlb->tags[i] == key) {
+            if (tlb->policy == TLB_LRU) {
+                tlb->stamps[i] = ++tlb->clock;
+            }
+            return i;
+        }
+    }
+    return -1;
+}
+
+// 키를 채우는 함수 (빈 슬롯이 없으면 같은 집합에서 시각이 가장 오래된 슬롯을 교체)
+void tlb_insert(Tlb* tlb, unsigned long key, PageTableEntry* entry) {
+    int base = (int)(key % tlb->sets) * tlb->ways;
+    int victim = base;
+    for (int i = base; i < base + tlb->ways; i++) {
+        if (tlb->tags[i] == TLB_INVALID) {
+            victim = i;
+            break;
+        }
+        if (tlb->stamps[i] < tlb->stamps[victim]) {
+            victim = i;
+        }
+    }
+    tlb->tags[victim] = key;
+    tlb->stamps[victim] = ++tlb->clock;
+    tlb->entries[victim] = entry;
+}
+
+// 키에 해당하는 엔트리를 무효화하는 함수 (페이지가 물리 메모리에서 쫓겨날 때 사용)
+void tlb_invalidate(Tlb* tlb, unsigned long key) {
+    int base = (int)(key % tlb->sets) * tlb->ways;
+    for (int i = base; i < base + tlb->ways; i++) {
+        if (tlb->tags[i] == key) {
+            tlb->tags[i] = TLB_INVALID;
+            tlb->entries[i] = NULL;
+        }
+    }
+}
+
+// Optimal 알고리즘을 위한 다음 사용 시점 정보
+// next_use[i]: i번째 액세스와 같은 페이지가 다시 참조되는 인덱스 (없으면 NEVER_USED)
+#define NEVER_USED INT_MAX
+
+// 노드 번호로 연결하는 이중 연결 리스트의 head(가장 최근)/tail(가장 오래됨)
+typedef struct {
+    int head;
+    int tail;
+    int size;
+} NodeList;
+
+static void node_list_init(NodeList* list) {
+    list->head = list->tail = -1;
+    list->size = 0;
+}
+
+static void node_list_remove(int* prev, int* next, NodeList* list, int node) {
+    if (prev[node] != -1) {
+        next[prev[node]] = next[node];
+    }
+    else {
+        list->head = next[node];
+    }
+    if (next[node] != -1) {
+        prev[next[node]] = prev[node];
+    }
+    else {
+        list->tail = prev[node];
+    }
+    list->size--;
+}
+
+static void node_list_push_front(int* prev, int* next, NodeList* list, int node) {
+    prev[node] = -1;
+    next[node] = list->head;
+    if (list->head != -1) {
+        prev[list->head] = node;
+    }
+    list->head = node;
+    if (list->tail == -1) {
+        list->tail = node;
+    }
+    list->size++;
+}
+
+// 노드 뒤에 새 노드를 삽입 (LFU 버킷 리스트에서 사용)
+static void node_list_insert_after(int* prev, int* next, NodeList* list, int after, int node) {
+    if (after == -1) {
+        node_list_push_front(prev, next, list, node);
+        return;
+    }
+    prev[node] = after;
+    next[node] = next[after];
+    if (next[after] != -1) {
+        prev[next[after]] = node;
+    }
+    else {
+        list->tail = node;
+    }
+    next[after] = node;
+    list->size++;
+}
+
+// 프리페치(read-ahead) 방식
+// 요구 폴트가 날 때만 동작하며, 예측한 페이지를 요구 페이지보다 먼저 적재하므로 요구 페이지가 같은 폴트의 프리페치로 쫓겨나지 않음
+typedef enum {
+    PREFETCH_NONE,
+    PREFETCH_SEQUENTIAL,    // 순차 스트림이 이어지면 창을 두 배씩 늘리는 read-ahead (쓰이지 않고 쫓겨난 페이지가 생기면 절반으로)
+    PREFETCH_STRIDE,        // 폴트 사이의 페이지 간격이 반복되면 그 간격으로 degree개
+    PREFETCH_MARKOV         // 폴트 페이지마다 직전에 이어졌던 폴트 페이지를 기억하는 후속 페이지 표
+} Prefetcher;
+
+const char* prefetcher_names[] = { "none", "seq", "stride", "markov" };
+#define PREFETCHER_COUNT 4
+#define PREFETCH_DEFAULT_DEGREE 8           // 순차 창의 최대 크기, stride의 프리페치 개수
+#define PREFETCH_INITIAL_WINDOW 2           // 순차 스트림을 처음 발견했을 때의 창 크기
+#define PREFETCH_MARKOV_WAYS 2              // Markov 표의 페이지당 후속 페이지 수
+#define PREFETCH_MARKOV_MAX_ENTRIES (1 << 16)
+
+typedef struct {
+    unsigned long page;                         // 표에 기록된 폴트 페이지 (비어 있으면 ULONG_MAX)
+    unsigned long next[PREFETCH_MARKOV_WAYS];   // 최근에 이어졌던 순서대로 후속 폴트 페이지
+} MarkovEntry;
+
+// 프리페치 통계
+typedef struct {
+    long issued;            // 프리페치로 적재한 페이지 수
+    long useful;            // 쫓겨나기 전에 참조된 프리페치 페이지 수 (폴트 대신 히트가 된 액세스)
+    long wasted;            // 참조되지 않고 쫓겨난 프리페치 페이지 수
+    long polluting_faults;  // 프리페치 때문에 쫓겨났던 페이지에서 다시 난 폴트 수
+} PrefetchStats;
+
+// 시뮬레이터 한 개의 전체 상태
+// 모든 상태를 Simulator가 소유하므로 한 프로세스 안에서 여러 시뮬레이션을 동시에 실행하거나
+// 같은 트레이스 구간을 여러 알고리즘이 나란히(lockstep) 처리할 수 있음
+typedef struct {
+    Algorithm algorithm;
+    int page_size;                      // 페이지 크기
+    int page_shift;                     // log2(페이지 크기)
+    int num_frames;                     // 프레임 개수
+    unsigned long total_pages;          // 가상주소 공간의 전체 페이지 수
+    unsigned long max_virtual_address;  // 가상주소 공간 크기
+
+    PageTable page_table;               // 페이지 테이블
+    unsigned long* physical_memory;     // 물리 메모리 (프레임 → 적재된 가상주소)
+    int current_frame;                  // 다음에 할당할 빈 프레임 (모든 프레임이 차면 num_frames)
+    int frame_limit;                    // 동시에 적재할 수 있는 프레임 수 (sim_set_frame_limit으로 줄이기 전에는 num_frames)
+
+    // FIFO/Second-Chance/Enhanced Second-Chance: 적재된 순서대로 프레임 번호를 담는 원형 큐 (Second-Chance 계열은 프론트가 시계 바늘)
+    int* frame_queue;
+    int front;                          // 큐의 프론트 인덱스
+    int queue_count;                    // 큐에 들어 있는 프레임 수
+
+    // Optimal: 프레임별 다음 사용 시점을 키로 하는 최대 힙 (가장 늦게 사용될 프레임이 루트)
+    const int* next_use;                // 트레이스의 다음 사용 시점 배열 (sim_set_next_use로 지정, 소유하지 않음)
+    int* opt_heap;                      // 힙 배열 (프레임 번호 저장)
+    int* opt_heap_pos;                  // 프레임 번호 → 힙 내 위치 (-1이면 힙에 없음)
+    int* opt_frame_key;                 // 프레임에 적재된 페이지의 다음 사용 시점
+    int opt_heap_size;
+
+    // LRU: 프레임 이중 연결 리스트 (head: 가장 최근 사용, tail: 가장 오래전 사용)
+    // 페이지 → 노드 대응은 페이지 테이블의 frame 필드가 담당하므로 별도의 탐색이 필요 없음
+    int* lru_prev;
+    int* lru_next;
+    int lru_head;
+    int lru_tail;
+
+    // TLB (sim_enable_tlb로 켜며, 켜지 않으면 매 액세스마다 페이지 테이블만 탐색)
+    int tlb_enabled;
+    Tlb tlb;
+    Tlb huge_tlb;                       // huge page TLB (huge_tlb.sets가 0이면 사용하지 않음)
+    PageMap huge_regions;               // 2MB 영역 → 물리 메모리에 적재된 페이지 수
+    long huge_threshold;                // 적재된 페이지가 이 수 이상인 영역은 huge page로 승격된 것으로 취급
+    int walk_cycles;                    // 기본 페이지의 페이지 테이블 탐색 비용
+    int huge_walk_cycles;               // huge page의 탐색 비용 (마지막 단계들을 생략)
+
+    // ARC/2Q/CLOCK-Pro/LFU: 노드 번호로 연결하는 이중 연결 리스트
+    // ARC/2Q/LFU는 노드 0 ~ num_frames - 1이 프레임이고, ARC/2Q의 ghost(기록만 남은 비적재 페이지)는 그 뒤의 노드를 사용
+    // CLOCK-Pro는 한 노드가 적재 상태와 테스트(비적재) 상태를 오가므로 노드와 프레임을 따로 대응시킴
+    int* node_prev;
+    int* node_next;
+    unsigned char* node_list;           // 노드가 속한 리스트 (ARC: T1/T2/B1/B2, 2Q: A1in/Am/A1out, CLOCK-Pro: 페이지 종류)
+    unsigned long* node_page;           // 노드의 페이지 번호
+    NodeList lists[4];
+    PageMap ghosts;                     // ghost 페이지 → 노드 번호
+    int free_node;                      // 사용하지 않는 노드 목록 (node_next로 연결, 없으면 -1)
+    int arc_target;                     // ARC: T1의 목표 크기 (p)
+    int q_in_max;                       // 2Q: A1in의 최대 크기 (Kin)
+    int q_out_max;                      // 2Q: A1out의 최대 크기 (Kout)
+
+    // CLOCK-Pro (노드들이 하나의 원형 리스트를 이루고 세 개의 시계 바늘이 돌아감)
+    int* node_frame;                    // 노드 → 프레임 (테스트 페이지면 -1)
+    int* frame_node;                    // 프레임 → 노드
+    unsigned char* node_ref;            // 참조 비트
+    int* free_frames;                   // 빈 프레임 스택 (CLOCK-Pro에서 한 번에 여러 페이지가 쫓겨나거나 할당이 줄어 비워진 프레임)
+    int free_frame_count;
+    int hand_hot, hand_cold, hand_test;
+    int count_hot, count_cold, count_test;
+    int mem_cold;                       // 콜드 페이지 목표 수 (테스트 페이지 재참조 시 증가, 테스트 만료 시 감소)
+    int in_hand_cold;                   // hand_cold 처리 중 여부 (재귀 방지)
+
+    // LFU: 빈도가 증가하는 순서로 연결된 버킷 리스트, 버킷마다 같은 빈도의 프레임 리스트
+    long* bucket_freq;
+    int* bucket_prev;
+    int* bucket_next;
+    NodeList* bucket_items;
+    int* frame_bucket;                  // 프레임 → 버킷
+    NodeList buckets;
+    int free_bucket;
+
+    // 프리페치 (sim_enable_prefetch로 켜며, 켜지 않으면 폴트마다 요구 페이지 하나만 적재)
+    Prefetcher prefetcher;
+    int prefetch_degree;
+    int prefetching;                    // 프리페치 페이지를 적재하는 중이면 1 (이때 쫓겨나는 페이지를 오염 후보로 표시)
+    unsigned long last_fault_page;      // 직전 요구 폴트의 페이지 (없으면 ULONG_MAX)
+    unsigned long stream_next;          // 순차/stride 스트림이 이어지면 다음 요구 폴트가 날 페이지
+    int ra_window;                      // 순차 read-ahead 창 크기 (0이면 스트림 없음)
+    long ra_wasted;                     // 직전 read-ahead 때의 prefetch.wasted (늘었으면 창을 줄임)
+    long stride;                        // 직전 두 폴트 사이의 페이지 간격
+    int stride_confirmed;               // 같은 간격이 두 번 이어졌으면 1
+    MarkovEntry* markov;
+    unsigned long markov_mask;          // Markov 표 크기 - 1 (2의 거듭제곱)
+    PrefetchStats prefetch;
+
+    long access_index;                  // 지금까지 처리한 액세스 수 (next_use의 인덱스)
+    long page_faults;                   // 지금까지 발생한 페이지 폴트 수
+    long write_backs;                   // 더티 페이지를 쫓아내며 디스크에 다시 쓴 횟수
+    long tlb_hits;                      // TLB 히트 수
+    long translation_cycles;            // 주소 변환에 든 모델 사이클 합계
+} Simulator;
+
+// 트레이스를 뒤에서부터 한 번 훑어 다음 사용 시점 배열을 만드는 함수
+// 같은 페이지 크기를 쓰는 시뮬레이터끼리는 결과 배열을 공유할 수 있음
+int* build_next_use(const unsigned long* accesses, int access_count, int page_shift) {
+    int* next_use = malloc((access_count + 1) * sizeof(int));
+    PageMap last_seen; // 페이지 → 가장 최근에 본(트레이스상으로는 다음) 참조 위치
+    page_map_init(&last_seen, 1024);
+
+    for (int i = access_count - 1; i >= 0; i--) {
+        long* seen = page_map_insert(&last_seen, accesses[i] >> page_shift, NEVER_USED);
+        next_use[i] = (int)*seen;
+        *seen = i;
+    }
+
+    page_map_free(&last_seen);
+    return next_use;
+}
+
+// 프레임 a가 프레임 b보다 교체 우선순위가 높은지 비교
+// 다시 사용되지 않는 페이지끼리는 번호가 작은 프레임을 먼저 교체 (기존 순차 탐색과 동일한 결과)
+static int opt_heap_before(Simulator* sim, int a, int b) {
+    if (sim->opt_frame_key[a] != sim->opt_frame_key[b]) {
+        return sim->opt_frame_key[a] > sim->opt_frame_key[b];
+    }
+    return a < b;
+}
+
+static void opt_heap_swap(Simulator* sim, int i, int j) {
+    int tmp = sim->opt_heap[i];
+    sim->opt_heap[i] = sim->opt_heap[j];
+    sim->opt_heap[j] = tmp;
+    sim->opt_heap_pos[sim->opt_heap[i]] = i;
+    sim->opt_heap_pos[sim->opt_heap[j]] = j;
+}
+
+static void opt_heap_sift_up(Simulator* sim, int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!opt_heap_before(sim, sim->opt_heap[i], sim->opt_heap[parent])) {
+            break;
+        }
+        opt_heap_swap(sim, i, parent);
+        i = parent;
+    }
+}
+
+static void opt_heap_sift_down(Simulator* sim, int i) {
+    while (1) {
+        int left = 2 * i + 1;
+        int right = left + 1;
+        int top = i;
+
+        if (left < sim->opt_heap_size && opt_heap_before(sim, sim->opt_heap[left], sim->opt_heap[top])) {
+            top = left;
+        }
+        if (right < sim->opt_heap_size && opt_heap_before(sim, sim->opt_heap[right], sim->opt_heap[top])) {
+            top = right;
+        }
+        if (top == i) {
+            break;
+        }
+        opt_heap_swap(sim, i, top);
+        i = top;
+    }
+}
+
+// 프레임의 다음 사용 시점을 갱신하고 힙 순서를 복구하는 함수 (힙에 없으면 삽입)
+void opt_heap_update(Simulator* sim, int frame, int key) {
+    sim->opt_frame_key[frame] = key;
+
+    if (sim->opt_heap_pos[frame] == -1) {
+        sim->opt_heap[sim->opt_heap_size] = frame;
+        sim->opt_heap_pos[frame] = sim->opt_heap_size;
+        sim->opt_heap_size++;
+        opt_heap_sift_up(sim, sim->opt_heap_size - 1);
+    }
+    else {
+        opt_heap_sift_up(sim, sim->opt_heap_pos[frame]);
+        opt_heap_sift_down(sim, sim->opt_heap_pos[frame]);
+    }
+}
+
+// 프레임에 적재된 페이지의 엔트리를 찾는 함수
+static PageTableEntry* frame_entry(Simulator* sim, int frame) {
+    return page_table_lookup(&sim->page_table, sim->physical_memory[frame] >> sim->page_shift, 0);
+}
+
+// 페이지가 물리 메모리에 적재될 때 huge page 영역의 적재 페이지 수를 갱신하는 함수
+static void tlb_page_loaded(Simulator* sim, unsigned long page_number) {
+    if (sim->tlb_enabled && sim->huge_tlb.sets > 0) {
+        (*page_map_insert(&sim->huge_regions, page_number >> (HUGE_PAGE_SHIFT - sim->page_shift), 0))++;
+    }
+}
+
+// 페이지가 쫓겨날 때 TLB 엔트리를 무효화하는 함수
+// huge page 영역은 적재된 페이지 수가 기준보다 적어지면 분할(demote)된 것으로 보고 huge page TLB에서도 제거
+static void tlb_page_evicted(Simulator* sim, unsigned long page_number) {
+    if (!sim->tlb_enabled) {
+        return;
+    }
+    tlb_invalidate(&sim->tlb, page_number);
+    if (sim->huge_tlb.sets > 0) {
+        unsigned long region = page_number >> (HUGE_PAGE_SHIFT - sim->page_shift);
+        long* resident = page_map_find(&sim->huge_regions, region);
+        if (--*resident < sim->huge_threshold) {
+            tlb_invalidate(&sim->huge_tlb, region);
+        }
+        if (*resident == 0) {
+            page_map_remove(&sim->huge_regions, region);
+        }
+    }
+}
+
+// TLB 미스 후 페이지 테이블을 탐색하고 변환 결과를 TLB에 채우는 함수
+// 영역이 huge page로 승격되어 있으면 huge page TLB에 채우고 탐색도 그만큼 짧아짐
+static void tlb_fill(Simulator* sim, unsigned long page_number, PageTableEntry* page_entry) {
+    if (sim->huge_tlb.sets > 0) {
+        unsigned long region = page_number >> (HUGE_PAGE_SHIFT - sim->page_shift);
+        long* resident = page_map_find(&sim->huge_regions, region);
+        if (resident != NULL && *resident >= sim->huge_threshold) {
+            tlb_insert(&sim->huge_tlb, region, NULL);
+            sim->translation_cycles += sim->huge_walk_cycles;
+            return;
+        }
+    }
+    tlb_insert(&sim->tlb, page_number, page_entry);
+    sim->translation_cycles += sim->walk_cycles;
+}
+
+// 프레임에 있던 페이지를 무효화하고 프레임을 비우는 함수 (더티 페이지면 쓰기 저장으로 집계)
+// 참조되지 않은 프리페치 페이지면 낭비로 집계하고, 프리페치할 자리를 만드는 중이면 오염 후보로 표시
+static void release_frame(Simulator* sim, int frame) {
+    PageTableEntry* entry = frame_entry(sim, frame);
+    sim->write_backs += entry->dirty;
+    sim->prefetch.wasted += entry->prefetched;
+    entry->valid = 0;
+    entry->dirty = 0;
+    entry->prefetched = sim->prefetching;
+    tlb_page_evicted(sim, sim->physical_memory[frame] >> sim->page_shift);
+    sim->physical_memory[frame] = ULONG_MAX;
+}
+
+// 교체 대상 프레임에 있던 페이지를 무효화하고 새 페이지를 적재하는 함수 (빈 프레임이면 적재만 함)
+static void replace_frame(Simulator* sim, int frame, PageTableEntry* page_entry, unsigned long virtual_address) {
+    if (sim->physical_memory[frame] != ULONG_MAX) {
+        release_frame(sim, frame); // 이전 페이지 무효화
+    }
+    tlb_page_loaded(sim, virtual_address >> sim->page_shift);
+
+    page_entry->frame = frame;
+    page_entry->valid = 1;
+    sim->physical_memory[frame] = virtual_address; // 물리 메모리 업데이트
+}
+
+// Optimal 알고리즘에 따라 교체할 프레임을 고르는 함수
+// 힙의 루트가 가장 늦게 사용될(또는 다시 사용되지 않을) 페이지의 프레임이므로 O(log F)에 교체 대상을 찾음
+int replace_page_optimal(Simulator* sim) {
+    return sim->opt_heap[0];
+}
+
+// FIFO/Second-Chance 큐의 tail에 프레임을 넣는 함수
+static void frame_queue_push(Simulator* sim, int frame) {
+    int tail = sim->front + sim->queue_count++;
+    sim->frame_queue[tail < sim->num_frames ? tail : tail - sim->num_frames] = frame;
+}
+
+// FIFO/Second-Chance 큐의 프론트에서 프레임을 꺼내는 함수
+static int frame_queue_pop(Simulator* sim) {
+    int frame = sim->frame_queue[sim->front];
+    if (++sim->front == sim->num_frames) {
+        sim->front = 0;
+    }
+    sim->queue_count--;
+    return frame;
+}
+
+// FIFO 페이지 교체 알고리즘: 가장 먼저 적재된 프레임부터 차례로 교체 (교체된 프레임은 새 페이지로 큐의 tail에 들어감)
+int replace_page_fifo(Simulator* sim) {
+    int frame_to_replace = frame_queue_pop(sim);
+    frame_queue_push(sim, frame_to_replace);
+    return frame_to_replace;
+}
+
+// 리스트에서 프레임을 떼어내는 함수
+static void lru_unlink(Simulator* sim, int frame) {
+    if (sim->lru_prev[frame] != -1) {
+        sim->lru_next[sim->lru_prev[frame]] = sim->lru_next[frame];
+    }
+    else {
+        sim->lru_head = sim->lru_next[frame];
+    }
+
+    if (sim->lru_next[frame] != -1) {
+        sim->lru_prev[sim->lru_next[frame]] = sim->lru_prev[frame];
+    }
+    else {
+        sim->lru_tail = sim->lru_prev[frame];
+    }
+}
+
+// 프레임을 리스트의 head에 삽입하는 함수
+static void lru_push_front(Simulator* sim, int frame) {
+    sim->lru_prev[frame] = -1;
+    sim->lru_next[frame] = sim->lru_head;
+    if (sim->lru_head != -1) {
+        sim->lru_prev[sim->lru_head] = frame;
+    }
+    sim->lru_head = frame;
+    if (sim->lru_tail == -1) {
+        sim->lru_tail = frame;
+    }
+}
+
+// 참조된 프레임을 head로 옮기는 함수 (O(1))
+void lru_touch(Simulator* sim, int frame) {
+    if (frame == sim->lru_head) {
+        return;
+    }
+    lru_unlink(sim, frame);
+    lru_push_front(sim, frame);
+}
+
+// LRU 알고리즘에 따라 교체할 프레임을 고르는 함수
+// tail 프레임이 가장 오래전에 사용된 페이지이므로 프레임 수와 관계없이 O(1)
+int replace_page_lru(Simulator* sim) {
+    int lruFrame = sim->lru_tail;
+    lru_touch(sim, lruFrame); // 새 페이지를 가장 최근 사용으로 표시
+    return lruFrame;
+}
+
+// Second-Chance 알고리즘에 따라 교체할 프레임을 고르는 함수
+int replace_page_second_chance(Simulator* sim) {
+    while (1) {
+        int frame = frame_queue_pop(sim);
+        PageTableEntry* entry = frame_entry(sim, frame);
+        frame_queue_push(sim, frame); // 참조 비트가 설정되었으면 큐의 뒤로 이동, 아니면 새 페이지로 큐의 뒤에 들어감
+
+        if (entry->reference_bit == 1) {
+            // 참조 비트가 설정된 경우: 참조 비트를 지우고 다음 프레임 확인
+            entry->reference_bit = 0;
+        } else {
+            // 참조 비트가 지워진 페이지를 교체 대상으로 선택
+            return frame;
+        }
+    }
+}
+
+// Enhanced Second-Chance 알고리즘에 따라 교체할 프레임을 고르는 함수
+// (참조, 더티) 등급 (0,0) → (0,1) → (1,0) → (1,1) 순으로 교체하여 쓰기 저장이 필요 없는 깨끗한 페이지를 먼저 쫓아냄
+// 1단계는 비트를 바꾸지 않고 (0,0)을 찾고, 없으면 2단계에서 참조 비트를 지우며 (0,1)을 찾음
+// 2단계까지 실패하면 모든 참조 비트가 지워졌으므로 다음 바퀴에서 반드시 교체 대상을 찾음
+int replace_page_enhanced_second_chance(Simulator* sim) {
+    while (1) {
+        for (int i = 0; i < sim->queue_count; i++) {
+            int frame = frame_queue_pop(sim);
+            PageTableEntry* entry = frame_entry(sim, frame);
+            frame_queue_push(sim, frame);
+            if (!entry->reference_bit && !entry->dirty) {
+                return frame;
+            }
+        }
+        for (int i = 0; i < sim->queue_count; i++) {
+            int frame = frame_queue_pop(sim);
+            PageTableEntry* entry = frame_entry(sim, frame);
+            frame_queue_push(sim, frame);
+            if (!entry->reference_bit) {
+                return frame;
+            }
+            entry->reference_bit = 0;
+        }
+    }
+}
+
+// ghost 노드를 하나 가져와 페이지를 기록하고 리스트의 head에 넣는 함수
+static void ghost_add(Simulator* sim, int list, unsigned long page_number) {
+    int node = sim->free_node;
+    sim->free_node = sim->node_next[node];
+    sim->node_page[node] = page_number;
+    sim->node_list[node] = (unsigned char)list;
+    node_list_push_front(sim->node_prev, sim->node_next, &sim->lists[list], node);
+    *page_map_insert(&sim->ghosts, page_number, node) = node;
+}
+
+// ghost 노드를 리스트에서 떼어내고 반환하는 함수
+static void ghost_remove(Simulator* sim, int node) {
+    node_list_remove(sim->node_prev, sim->node_next, &sim->lists[sim->node_list[node]], node);
+    page_map_remove(&sim->ghosts, sim->node_page[node]);
+    sim->node_next[node] = sim->free_node;
+    sim->free_node = node;
+}
+
+// ghost로 기록된 페이지의 노드 번호 (없으면 -1)
+static int ghost_find(Simulator* sim, unsigned long page_number) {
+    long* node = page_map_find(&sim->ghosts, page_number);
+    return node != NULL ? (int)*node : -1;
+}
+
+// 적재된 페이지의 프레임을 리스트의 tail에서 떼어내는 함수 (ghost_list가 -1이 아니면 그 리스트에 기록을 남김)
+static int evict_tail(Simulator* sim, int list, int ghost_list) {
+    int frame = sim->lists[list].tail;
+    node_list_remove(sim->node_prev, sim->node_next, &sim->lists[list], frame);
+    if (ghost_list != -1) {
+        ghost_add(sim, ghost_list, sim->physical_memory[frame] >> sim->page_shift);
+    }
+    return frame;
+}
+
+// 프레임을 리스트의 head(가장 최근)에 넣는 함수
+static void resident_push(Simulator* sim, int list, int frame) {
+    sim->node_list[frame] = (unsigned char)list;
+    node_list_push_front(sim->node_prev, sim->node_next, &sim->lists[list], frame);
+}
+
+// ARC (Megiddo & Modha): T1은 한 번, T2는 두 번 이상 참조된 페이지, B1/B2는 각각에서 쫓겨난 페이지의 기록
+// B1에서 다시 참조되면 최근성(T1)을, B2에서 다시 참조되면 빈도(T2)를 더 중시하도록 목표 크기 p를 조정하므로
+// 한 번만 읽고 지나가는 대량 스캔이 T2의 자주 쓰는 페이지를 밀어내지 못함
+enum { ARC_T1, ARC_T2, ARC_B1, ARC_B2 };
+
+static int arc_replace(Simulator* sim, int in_b2) {
+    int t1 = sim->lists[ARC_T1].size;
+    if (t1 > 0 && (t1 > sim->arc_target || (in_b2 && t1 == sim->arc_target) || sim->lists[ARC_T2].size == 0)) {
+        return evict_tail(sim, ARC_T1, ARC_B1);
+    }
+    return evict_tail(sim, ARC_T2, ARC_B2);
+}
+
+static int arc_fault(Simulator* sim, unsigned long page_number) {
+    int c = sim->num_frames;
+    int ghost = ghost_find(sim, page_number);
+    int frame;
+
+    if (ghost != -1) {
+        // ghost 히트: 목표 크기를 조정한 뒤 교체하고 T2에 넣음
+        int b1 = sim->lists[ARC_B1].size;
+        int b2 = sim->lists[ARC_B2].size;
+        int in_b2 = sim->node_list[ghost] == ARC_B2;
+        if (!in_b2) {
+            int delta = b2 / b1 > 1 ? b2 / b1 : 1;
+            sim->arc_target = sim->arc_target + delta < c ? sim->arc_target + delta : c;
+        }
+        else {
+            int delta = b1 / b2 > 1 ? b1 / b2 : 1;
+            sim->arc_target = sim->arc_target - delta > 0 ? sim->arc_target - delta : 0;
+        }
+        ghost_remove(sim, ghost);
+        frame = arc_replace(sim, in_b2);
+        resident_push(sim, ARC_T2, frame);
+        return frame;
+    }
+
+    if (sim->current_frame < c) {
+        frame = sim->current_frame++;
+    }
+    else if (sim->lists[ARC_T1].size + sim->lists[ARC_B1].size >= c) {
+        if (sim->lists[ARC_T1].size < c) {
+            ghost_remove(sim, sim->lists[ARC_B1].tail);
+            frame = arc_replace(sim, 0);
+        }
+        else {
+            frame = evict_tail(sim, ARC_T1, -1);
+        }
+    }
+    else {
+        if (sim->lists[ARC_T1].size + sim->lists[ARC_T2].size + sim->lists[ARC_B1].size + sim->lists[ARC_B2].size >= 2 * c) {
+            ghost_remove(sim, sim->lists[ARC_B2].tail);
+        }
+        frame = arc_replace(sim, 0);
+    }
+    resident_push(sim, ARC_T1, frame);
+    return frame;
+}
+
+static void arc_hit(Simulator* sim, int frame) {
+    node_list_remove(sim->node_prev, sim->node_next, &sim->lists[sim->node_list[frame]], frame);
+    resident_push(sim, ARC_T2, frame);
+}
+
+// 2Q (Johnson & Shasha): 처음 참조된 페이지는 FIFO인 A1in에 두고, A1in에서 쫓겨난 페이지는 A1out에 기록만 남김
+// A1out에 기록이 있는 동안 다시 참조된 페이지만 LRU인 Am으로 올라가므로 스캔은 A1in만 거쳐 지나감
+enum { Q_A1IN, Q_AM, Q_A1OUT };
+
+static int two_queue_fault(Simulator* sim, unsigned long page_number) {
+    int ghost = ghost_find(sim, page_number);
+    int frame;
+
+    if (ghost != -1) {
+        ghost_remove(sim, ghost);
+    }
+    if (sim->current_frame < sim->num_frames) {
+        frame = sim->current_frame++;
+    }
+    else if (sim->lists[Q_A1IN].size > sim->q_in_max || sim->lists[Q_AM].size == 0) {
+        if (sim->lists[Q_A1OUT].size >= sim->q_out_max) {
+            ghost_remove(sim, sim->lists[Q_A1OUT].tail);
+        }
+        frame = evict_tail(sim, Q_A1IN, Q_A1OUT);
+    }
+    else {
+        frame = evict_tail(sim, Q_AM, -1);
+    }
+    resident_push(sim, ghost != -1 ? Q_AM : Q_A1IN, frame);
+    return frame;
+}
+
+static void two_queue_hit(Simulator* sim, int frame) {
+    if (sim->node_list[frame] == Q_AM) {
+        node_list_remove(sim->node_prev, sim->node_next, &sim->lists[Q_AM], frame);
+        resident_push(sim, Q_AM, frame);
+    }
+}
+
+// CLOCK-Pro (Jiang, Chen & Zhang): 핫/콜드 적재 페이지와 최근 쫓겨난 콜드 페이지(테스트 페이지)가 한 원형 리스트에 있고
+// hand_cold는 콜드 페이지를 쫓아내며, 참조된 콜드 페이지는 핫으로 승격
+// hand_hot은 참조되지 않은 핫 페이지를 콜드로 강등하고, hand_test는 오래된 테스트 페이지를 지움
+// 테스트 기간 안에 다시 참조된 페이지는 재사용 거리가 짧은 것이므로 핫으로 바로 적재하고 콜드 목표 수(mem_cold)를 늘림
+// (go-clockpro의 구조를 따름)
+enum { CP_HOT, CP_COLD, CP_TEST };
+
+static void clock_pro_run_hand_cold(Simulator* sim);
+
+// 노드를 원형 리스트에서 떼어내는 함수 (바늘이 가리키고 있으면 이전 노드로 옮김)
+static void clock_pro_unlink(Simulator* sim, int node) {
+    int prev = sim->node_prev[node];
+    int next = sim->node_next[node];
+
+    if (next == node) {
+        sim->hand_hot = sim->hand_cold = sim->hand_test = -1;
+        return;
+    }
+    if (sim->hand_hot == node) sim->hand_hot = prev;
+    if (sim->hand_cold == node) sim->hand_cold = prev;
+    if (sim->hand_test == node) sim->hand_test = prev;
+    sim->node_next[prev] = next;
+    sim->node_prev[next] = prev;
+}
+
+// 테스트 페이지를 지우는 바늘
+static void clock_pro_run_hand_test(Simulator* sim) {
+    // hand_test가 hand_cold를 앞지르지 않도록 먼저 hand_cold를 진행
+    // (재귀 깊이가 노드 수를 넘으면 바늘이 더 진행할 수 없는 것이므로 멈춤: 프레임이 하나일 때 무한히 재귀하는 것을 방지)
+    if (sim->hand_test == sim->hand_cold && sim->in_hand_cold <= 2 * sim->num_frames + 1) {
+        clock_pro_run_hand_cold(sim);
+    }
+    int node = sim->hand_test;
+    if (sim->node_list[node] == CP_TEST) {
+        int prev = sim->node_prev[node];
+        clock_pro_unlink(sim, node);
+        page_map_remove(&sim->ghosts, sim->node_page[node]);
+        sim->node_next[node] = sim->free_node;
+        sim->free_node = node;
+        sim->hand_test = prev;
+        sim->count_test--;
+        if (sim->mem_cold > 1) {
+            sim->mem_cold--;
+        }
+    }
+    sim->hand_test = sim->node_next[sim->hand_test];
+}
+
+// 핫 페이지를 강등하는 바늘
+static void clock_pro_run_hand_hot(Simulator* sim) {
+    if (sim->hand_hot == sim->hand_test) {
+        clock_pro_run_hand_test(sim);
+    }
+    int node = sim->hand_hot;
+    if (sim->node_list[node] == CP_HOT) {
+        if (sim->node_ref[node]) {
+            sim->node_ref[node] = 0;
+        }
+        else {
+            sim->node_list[node] = CP_COLD;
+            sim->count_hot--;
+            sim->count_cold++;
+        }
+    }
+    sim->hand_hot = sim->node_next[sim->hand_hot];
+}
+
+// 콜드 페이지를 쫓아내는 바늘 (쫓겨난 페이지의 프레임은 빈 프레임 스택에 넣음)
+static void clock_pro_run_hand_cold(Simulator* sim) {
+    int node = sim->hand_cold;
+    sim->in_hand_cold++;
+    if (sim->node_list[node] == CP_COLD) {
+        if (sim->node_ref[node]) {
+            sim->node_list[node] = CP_HOT;
+            sim->node_ref[node] = 0;
+            sim->count_cold--;
+            sim->count_hot++;
+        }
+        else {
+            int frame = sim->node_frame[node];
+            release_frame(sim, frame);
+            sim->free_frames[sim->free_frame_count++] = frame;
+            sim->node_frame[node] = -1;
+            sim->node_list[node] = CP_TEST;
+            *page_map_insert(&sim->ghosts, sim->node_page[node], node) = node;
+            sim->count_cold--;
+            sim->count_test++;
+            while (sim->num_frames < sim->count_test) {
+                clock_pro_run_hand_test(sim);
+            }
+        }
+    }
+    sim->hand_cold = sim->node_next[sim->hand_cold];
+    while (sim->num_frames - sim->mem_cold < sim->count_hot) {
+        clock_pro_run_hand_hot(sim);
+    }
+    sim->in_hand_cold--;
+}
+
+// 필요하면 페이지를 쫓아낸 뒤 노드를 hand_hot 바로 앞에 넣는 함수
+static void clock_pro_add(Simulator* sim, int node) {
+    while (sim->num_frames <= sim->count_hot + sim->count_cold) {
+        clock_pro_run_hand_cold(sim);
+    }
+
+    if (sim->hand_hot == -1) {
+        sim->node_prev[node] = sim->node_next[node] = node;
+        sim->hand_hot = sim->hand_cold = sim->hand_test = node;
+    }
+    else {
+        int prev = sim->node_prev[sim->hand_hot];
+        sim->node_prev[node] = prev;
+        sim->node_next[node] = sim->hand_hot;
+        sim->node_next[prev] = node;
+        sim->node_prev[sim->hand_hot] = node;
+    }
+    if (sim->hand_cold == sim->hand_hot) {
+        sim->hand_cold = sim->node_prev[sim->hand_cold];
+    }
+}
+
+static int clock_pro_fault(Simulator* sim, unsigned long page_number) {
+    int node = ghost_find(sim, page_number);
+
+    if (node != -1) {
+        // 테스트 페이지 재참조: 핫 페이지로 적재
+        if (sim->mem_cold < sim->num_frames) {
+            sim->mem_cold++;
+        }
+        page_map_remove(&sim->ghosts, page_number);
+        sim->count_test--;
+        clock_pro_unlink(sim, node);
+        sim->node_list[node] = CP_HOT;
+        sim->node_ref[node] = 0;
+        clock_pro_add(sim, node);
+        sim->count_hot++;
+    }
+    else {
+        node = sim->free_node;
+        sim->free_node = sim->node_next[node];
+        sim->node_page[node] = page_number;
+        sim->node_list[node] = CP_COLD;
+        sim->node_ref[node] = 0;
+        clock_pro_add(sim, node);
+        sim->count_cold++;
+    }
+
+    int frame = sim->current_frame < sim->num_frames ? sim->current_frame++ : sim->free_frames[--sim->free_frame_count];
+    sim->node_frame[node] = frame;
+    sim->frame_node[frame] = node;
+    return frame;
+}
+
+// O(1) LFU (Shah, Mitra & Matani): 빈도별 버킷을 빈도 순서로 연결하고, 참조 시 프레임을 다음 빈도 버킷으로 옮김
+// 교체 대상은 가장 낮은 빈도 버킷에서 가장 오래 머문 프레임 (같은 빈도끼리는 LRU)
+static int lfu_bucket_after(Simulator* sim, int after, long freq) {
+    int next = after == -1 ? sim->buckets.head : sim->bucket_next[after];
+    if (next != -1 && sim->bucket_freq[next] == freq) {
+        return next;
+    }
+    int bucket = sim->free_bucket;
+    sim->free_bucket = sim->bucket_next[bucket];
+    sim->bucket_freq[bucket] = freq;
+    node_list_init(&sim->bucket_items[bucket]);
+    node_list_insert_after(sim->bucket_prev, sim->bucket_next, &sim->buckets, after, bucket);
+    return bucket;
+}
+
+// 프레임을 버킷에서 떼어내고 버킷이 비면 반환하는 함수
+static void lfu_detach(Simulator* sim, int frame) {
+    int bucket = sim->frame_bucket[frame];
+    node_list_remove(sim->node_prev, sim->node_next, &sim->bucket_items[bucket], frame);
+    if (sim->bucket_items[bucket].size == 0) {
+        node_list_remove(sim->bucket_prev, sim->bucket_next, &sim->buckets, bucket);
+        sim->bucket_next[bucket] = sim->free_bucket;
+        sim->free_bucket = bucket;
+    }
+}
+
+static int lfu_fault(Simulator* sim, unsigned long page_number) {
+    (void)page_number;
+    int frame;
+
+    if (sim->current_frame < sim->num_frames) {
+        frame = sim->current_frame++;
+    }
+    else {
+        frame = sim->bucket_items[sim->buckets.head].tail;
+        lfu_detach(sim, frame);
+    }
+    int bucket = lfu_bucket_after(sim, -1, 1);
+    sim->frame_bucket[frame] = bucket;
+    node_list_push_front(sim->node_prev, sim->node_next, &sim->bucket_items[bucket], frame);
+    return frame;
+}
+
+static void lfu_hit(Simulator* sim, int frame) {
+    int bucket = sim->frame_bucket[frame];
+    int next = lfu_bucket_after(sim, bucket, sim->bucket_freq[bucket] + 1);
+    lfu_detach(sim, frame);
+    sim->frame_bucket[frame] = next;
+    node_list_push_front(sim->node_prev, sim->node_next, &sim->bucket_items[next], frame);
+}
+
+// ARC/2Q/CLOCK-Pro/LFU 페이지 폴트 처리 (빈 프레임 또는 교체 대상 프레임을 반환)
+int policy_fault(Simulator* sim, unsigned long page_number) {
+    switch (sim->algorithm) {
+    case ARC:
+        return arc_fault(sim, page_number);
+    case TWO_QUEUE:
+        return two_queue_fault(sim, page_number);
+    case CLOCK_PRO:
+        return clock_pro_fault(sim, page_number);
+    default:
+        return lfu_fault(sim, page_number);
+    }
+}
+
+// ARC/2Q/CLOCK-Pro/LFU 페이지 히트 처리
+void policy_hit(Simulator* sim, int frame) {
+    switch (sim->algorithm) {
+    case ARC:
+        arc_hit(sim, frame);
+        break;
+    case TWO_QUEUE:
+        two_queue_hit(sim, frame);
+        break;
+    case CLOCK_PRO:
+        sim->node_ref[sim->frame_node[frame]] = 1;
+        break;
+    default:
+        lfu_hit(sim, frame);
+        break;
+    }
+}
+
+// sim_set_frame_limit으로 할당을 줄일 수 있는 알고리즘인지 여부 (프레임 큐나 LRU 리스트의 순서대로 쫓아낼 수 있는 경우)
+int sim_supports_frame_limit(Algorithm algorithm) {
+    return algorithm == FIFO || algorithm == LRU || algorithm == SECOND_CHANCE || algorithm == ENHANCED_SECOND_CHANCE;
+}
+
+// 시뮬레이터를 초기화하는 함수 (성공 시 0, 설정이 잘못되었으면 -1)
+int sim_init(Simulator* sim, Algorithm algorithm, int address_bits, int page_size, long physical_memory_size) {
+    memset(sim, 0, sizeof(Simulator));
+    if (page_size <= 0 || (page_size & (page_size - 1)) != 0 || physical_memory_size < page_size
+        || address_bits >= (int)(8 * sizeof(unsigned long)) || physical_memory_size / page_size > MAX_FRAMES) {
+        return -1;
+    }
+
+    sim->algorithm = algorithm;
+    sim->page_size = page_size;
+    while ((1 << sim->page_shift) < page_size) {
+        sim->page_shift++;
+    }
+    if (sim->page_shift > address_bits) {
+        return -1;
+    }
+    sim->max_virtual_address = 1UL << address_bits;
+    sim->num_frames = (int)(physical_memory_size / page_size); // 프레임 개수 계산
+    sim->total_pages = sim->max_virtual_address >> sim->page_shift; // 전체 페이지 수 계산
+    sim->frame_limit = sim->num_frames;
+    sim->lru_head = sim->lru_tail = -1;
+
+    // 페이지 테이블 및 물리 메모리 초기화
+    page_table_init(&sim->page_table, address_bits - sim->page_shift);
+    sim->physical_memory = malloc(sim->num_frames * sizeof(unsigned long));
+    for (int i = 0; i < sim->num_frames; i++) {
+        sim->physical_memory[i] = ULONG_MAX; // 물리 메모리를 초기값으로 설정
+    }
+
+    if (algorithm == OPTIMAL) {
+        sim->opt_heap = malloc(sim->num_frames * sizeof(int));
+        sim->opt_heap_pos = malloc(sim->num_frames * sizeof(int));
+        sim->opt_frame_key = malloc(sim->num_frames * sizeof(int));
+        for (int i = 0; i < sim->num_frames; i++) {
+            sim->opt_heap_pos[i] = -1;
+        }
+    }
+    if (algorithm == LRU) {
+        sim->lru_prev = malloc(sim->num_frames * sizeof(int));
+        sim->lru_next = malloc(sim->num_frames * sizeof(int));
+    }
+    if (algorithm == FIFO || algorithm == SECOND_CHANCE || algorithm == ENHANCED_SECOND_CHANCE) {
+        sim->frame_queue = malloc(sim->num_frames * sizeof(int));
+    }
+    if (sim_supports_frame_limit(algorithm) || algorithm == CLOCK_PRO) {
+        sim->free_frames = malloc(sim->num_frames * sizeof(int));
+    }
+    if (algorithm >= ARC) {
+        // 프레임 노드 + ghost 노드 (CLOCK-Pro는 적재 페이지와 테스트 페이지가 각각 최대 프레임 수만큼, 추가 중인 노드 1개)
+        int node_count = 2 * sim->num_frames + 1;
+        sim->node_prev = malloc(node_count * sizeof(int));
+        sim->node_next = malloc(node_count * sizeof(int));
+        sim->node_list = malloc(node_count);
+        sim->node_page = malloc(node_count * sizeof(unsigned long));
+        for (int i = 0; i < 4; i++) {
+            node_list_init(&sim->lists[i]);
+        }
+        page_map_init(&sim->ghosts, sim->num_frames);
+
+        // ARC/2Q는 프레임 번호 뒤의 노드만 ghost로 사용
+        int first_free = (algorithm == CLOCK_PRO) ? 0 : sim->num_frames;
+        sim->free_node = -1;
+        for (int i = node_count - 1; i >= first_free; i--) {
+            sim->node_next[i] = sim->free_node;
+            sim->free_node = i;
+        }
+        sim->q_in_max = sim->num_frames / 4 > 1 ? sim->num_frames / 4 : 1;
+        sim->q_out_max = sim->num_frames / 2 > 1 ? sim->num_frames / 2 : 1;
+    }
+    if (algorithm == CLOCK_PRO) {
+        sim->node_frame = malloc((2 * sim->num_frames + 1) * sizeof(int));
+        sim->node_ref = malloc(2 * sim->num_frames + 1);
+        sim->frame_node = malloc(sim->num_frames * sizeof(int));
+        sim->hand_hot = sim->hand_cold = sim->hand_test = -1;
+        sim->mem_cold = sim->num_frames;
+    }
+    if (algorithm == LFU) {
+        int bucket_count = sim->num_frames + 1; // 비어 있지 않은 버킷 + 히트 처리 중 새로 만드는 버킷 1개
+        sim->bucket_freq = malloc(bucket_count * sizeof(long));
+        sim->bucket_prev = malloc(bucket_count * sizeof(int));
+        sim->bucket_next = malloc(bucket_count * sizeof(int));
+        sim->bucket_items = malloc(bucket_count * sizeof(NodeList));
+        sim->frame_bucket = malloc(sim->num_frames * sizeof(int));
+        node_list_init(&sim->buckets);
+        sim->free_bucket = -1;
+        for (int i = bucket_count - 1; i >= 0; i--) {
+            sim->bucket_next[i] = sim->free_bucket;
+            sim->free_bucket = i;
+        }
+    }
+    return 0;
+}
+
+// Optimal 알고리즘이 사용할 다음 사용 시점 배열을 지정하는 함수 (배열은 시뮬레이션이 끝날 때까지 유지되어야 함)
+void sim_set_next_use(Simulator* sim, const int* next_use) {
+    sim->next_use = next_use;
+}
+
+// 동시에 적재할 수 있는 프레임 수를 바꾸는 함수 (쫓아낸 페이지 수 반환, 지원하지 않는 알고리즘이거나 범위를 벗어나면 -1)
+// 교체 범위가 프로세스 안으로 한정된 다중 프로세스 시뮬레이션에서 할당을 조절할 때 사용 (FIFO/LRU/Second-Chance 계열만 지원)
+// 줄이면 각 알고리즘의 교체 순서대로 페이지를 쫓아내고, 비워진 프레임은 free_frames에 쌓였다가 다음 폴트에서 먼저 사용됨
+int sim_set_frame_limit(Simulator* sim, int limit) {
+    if (!sim_supports_frame_limit(sim->algorithm) || limit < 1 || limit > sim->num_frames) {
+        return -1;
+    }
+
+    int evicted = 0;
+    sim->frame_limit = limit;
+    while (sim->current_frame - sim->free_frame_count > limit) {
+        int frame;
+        if (sim->algorithm == LRU) {
+            frame = sim->lru_tail;
+            lru_unlink(sim, frame);
+        }
+        else {
+            // 교체 대상을 고르면 큐의 tail에 다시 들어가므로 바로 빼냄
+            frame = sim->algorithm == FIFO ? replace_page_fifo(sim)
+                : sim->algorithm == SECOND_CHANCE ? replace_page_second_chance(sim)
+                : replace_page_enhanced_second_chance(sim);
+            sim->queue_count--;
+        }
+        release_frame(sim, frame);
+        sim->free_frames[sim->free_frame_count++] = frame;
+        evicted++;
+    }
+    return evicted;
+}
+
+// TLB 모델을 켜는 함수 (성공 시 0, 설정이 잘못되었으면 -1)
+// 탐색 비용은 페이지 테이블 단계 수 × 단계당 비용이며, huge page는 2MB 아래의 단계를 생략
+// 영역(2MB)의 페이지가 절반 이상 적재되면 khugepaged처럼 huge page로 승격된 것으로 취급
+int sim_enable_tlb(Simulator* sim, const TlbConfig* config) {
+    if (tlb_init(&sim->tlb, config->entries, config->ways, config->policy) == -1 || config->walk_cycles <= 0) {
+        tlb_free(&sim->tlb);
+        return -1;
+    }
+    sim->walk_cycles = sim->page_table.levels * config->walk_cycles;
+
+    if (config->huge_entries > 0) {
+        if (sim->page_shift >= HUGE_PAGE_SHIFT || tlb_init(&sim->huge_tlb, config->huge_entries, 0, config->policy) == -1) {
+            tlb_free(&sim->tlb);
+            return -1;
+        }
+        int huge_levels = sim->page_table.levels - (HUGE_PAGE_SHIFT - sim->page_shift) / PT_LEVEL_BITS;
+        sim->huge_walk_cycles = (huge_levels > 1 ? huge_levels : 1) * config->walk_cycles;
+        sim->huge_threshold = (1L << (HUGE_PAGE_SHIFT - sim->page_shift)) / 2;
+        page_map_init(&sim->huge_regions, 64);
+    }
+    sim->tlb_enabled = 1;
+    return 0;
+}
+
+// 프리페치를 켜는 함수 (성공 시 0, 설정이 잘못되었으면 -1)
+// degree는 순차 read-ahead 창의 최대 크기이자 stride의 프리페치 개수 (Markov는 기억한 후속 페이지를 모두 적재)
+// Optimal은 프리페치 페이지의 다음 사용 시점을 알 수 없으므로 지원하지 않음
+int sim_enable_prefetch(Simulator* sim, Prefetcher prefetcher, int degree) {
+    if (sim->algorithm == OPTIMAL || degree < 1) {
+        return -1;
+    }
+    sim->prefetcher = prefetcher;
+    sim->prefetch_degree = degree;
+    sim->last_fault_page = sim->stream_next = ULONG_MAX;
+
+    if (prefetcher == PREFETCH_MARKOV) {
+        // 표 크기는 프레임 수의 16배 (1024 ~ PREFETCH_MARKOV_MAX_ENTRIES), 같은 자리에 겹치면 새 페이지가 덮어씀
+        unsigned long entries = 1024;
+        while (entries < 16UL * sim->num_frames && entries < PREFETCH_MARKOV_MAX_ENTRIES) {
+            entries <<= 1;
+        }
+        sim->markov = malloc(entries * sizeof(MarkovEntry));
+        sim->markov_mask = entries - 1;
+        for (unsigned long i = 0; i < entries; i++) {
+            sim->markov[i].page = ULONG_MAX;
+        }
+    }
+    return 0;
+}
+
+void sim_free(Simulator* sim) {
+    if (sim->tlb_enabled) {
+        tlb_free(&sim->tlb);
+        if (sim->huge_tlb.sets > 0) {
+            tlb_free(&sim->huge_tlb);
+            page_map_free(&sim->huge_regions);
+        }
+    }
+    page_table_free(&sim->page_table);
+    free(sim->physical_memory);
+    free(sim->opt_heap);
+    free(sim->opt_heap_pos);
+    free(sim->opt_frame_key);
+    free(sim->lru_prev);
+    free(sim->lru_next);
+    free(sim->frame_queue);
+    if (sim->algorithm >= ARC) {
+        free(sim->node_prev);
+        free(sim->node_next);
+        free(sim->node_list);
+        free(sim->node_page);
+        page_map_free(&sim->ghosts);
+    }
+    free(sim->node_frame);
+    free(sim->node_ref);
+    free(sim->frame_node);
+    free(sim->free_frames);
+    free(sim->bucket_freq);
+    free(sim->bucket_prev);
+    free(sim->bucket_next);
+    free(sim->bucket_items);
+    free(sim->frame_bucket);
+    free(sim->markov);
+    memset(sim, 0, sizeof(Simulator));
+}
+
+// 비어 있는 엔트리의 페이지를 물리 메모리에 적재하는 함수 (적재한 프레임 번호 반환)
+// 빈 프레임이 있으면 사용하고, 없으면 알고리즘에 따라 교체할 프레임을 골라 이전 페이지를 쫓아냄
+static int load_page(Simulator* sim, PageTableEntry* page_entry, unsigned long virtual_address) {
+    unsigned long page_number = virtual_address >> sim->page_shift;
+    int frame_number;
+
+    if (sim->algorithm >= ARC) {
+        // ARC/2Q/CLOCK-Pro/LFU는 ghost 기록과 빈 프레임을 정책이 직접 관리
+        frame_number = policy_fault(sim, page_number);
+        replace_frame(sim, frame_number, page_entry, virtual_address);
+    }
+    else if (sim->current_frame - sim->free_frame_count < sim->frame_limit) {
+        // 물리 메모리에 여유가 있는 경우 (할당이 줄어 비워진 프레임이 있으면 먼저 사용)
+        frame_number = sim->free_frame_count > 0 ? sim->free_frames[--sim->free_frame_count] : sim->current_frame++;
+        // LRU 알고리즘의 경우 새 프레임을 리스트의 head에 추가
+        if (sim->algorithm == LRU) {
+            lru_push_front(sim, frame_number);
+        }
+        // FIFO/Second-Chance 계열 알고리즘의 경우 새 프레임을 큐의 tail에 추가
+        if (sim->algorithm == FIFO || sim->algorithm == SECOND_CHANCE || sim->algorithm == ENHANCED_SECOND_CHANCE) {
+            frame_queue_push(sim, frame_number);
+        }
+        // Second-Chance 계열 알고리즘의 경우 reference_bit 설정
+        if (sim->algorithm == SECOND_CHANCE || sim->algorithm == ENHANCED_SECOND_CHANCE) {
+            page_entry->reference_bit = 1;
+        }
+        page_entry->valid = 1; // 페이지 엔트리를 유효하게 설정
+        page_entry->frame = frame_number;
+        sim->physical_memory[frame_number] = virtual_address;
+        tlb_page_loaded(sim, page_number);
+    }
+    else {
+        // 물리 메모리에 여유가 없어 페이지 교체가 필요한 경우
+        switch (sim->algorithm) {
+        case OPTIMAL:
+            frame_number = replace_page_optimal(sim);
+            break;
+        case FIFO:
+            frame_number = replace_page_fifo(sim);
+            break;
+        case LRU:
+            frame_number = replace_page_lru(sim);
+            break;
+        case SECOND_CHANCE:
+            frame_number = replace_page_second_chance(sim);
+            break;
+        case ENHANCED_SECOND_CHANCE:
+            frame_number = replace_page_enhanced_second_chance(sim);
+            page_entry->reference_bit = 1; // 새 페이지는 방금 참조된 것으로 표시
+            break;
+        default:
+            fprintf(stderr, "알 수 없는 페이지 교체 알고리즘입니다.\n");
+            exit(1);
+        }
+        replace_frame(sim, frame_number, page_entry, virtual_address);
+    }
+    return frame_number;
+}
+
+// 예측한 페이지 하나를 프리페치하는 함수 (가상주소 공간 밖이거나 요구 페이지이거나 이미 적재된 페이지면 무시)
+// 프리페치 페이지는 참조되지 않은 상태(참조 비트 0)로 적재되며, 처음 참조될 때 유용한 프리페치로 집계
+static void prefetch_page(Simulator* sim, unsigned long page_number, unsigned long demand_page) {
+    if (page_number >= sim->total_pages || page_number == demand_page) {
+        return;
+    }
+    PageTableEntry* entry = page_table_lookup(&sim->page_table, page_number, 1);
+    if (entry->valid) {
+        return;
+    }
+    sim->prefetching = 1;
+    load_page(sim, entry, page_number << sim->page_shift);
+    sim->prefetching = 0;
+    entry->prefetched = 1;
+    entry->reference_bit = 0;
+    sim->prefetch.issued++;
+}
+
+// Markov 표에서 페이지의 자리를 찾는 함수
+static MarkovEntry* markov_slot(Simulator* sim, unsigned long page_number) {
+    return &sim->markov[(page_number * 0x9E3779B97F4A7C15UL >> 32) & sim->markov_mask];
+}
+
+// 요구 폴트가 날 때 프리페처를 학습시키고 예측한 페이지들을 적재하는 함수
+// 한 번에 적재하는 페이지는 프레임 수의 절반까지로 제한하여 작업 집합 전체를 밀어내지 않도록 함
+static void prefetch_on_fault(Simulator* sim, unsigned long page_number) {
+    int budget = sim->frame_limit / 2 < sim->prefetch_degree ? sim->frame_limit / 2 : sim->prefetch_degree;
+    int continues = (page_number == sim->stream_next); // 직전 프리페치가 맞아 스트림의 다음 구간에서 폴트가 남
+
+    switch (sim->prefetcher) {
+    case PREFETCH_SEQUENTIAL:
+        if (continues || page_number == sim->last_fault_page + 1) {
+            // 스트림이 이어지면 창을 두 배로 (직전 read-ahead 이후 쓰이지 않고 쫓겨난 페이지가 있으면 절반으로)
+            int window = sim->ra_window == 0 ? PREFETCH_INITIAL_WINDOW
+                : sim->prefetch.wasted > sim->ra_wasted ? sim->ra_window / 2
+                : sim->ra_window * 2;
+            sim->ra_window = window < 1 ? 1 : window > sim->prefetch_degree ? sim->prefetch_degree : window;
+        }
+        else {
+            sim->ra_window = 0;
+        }
+        sim->ra_wasted = sim->prefetch.wasted;
+        if (sim->ra_window > 0) {
+            int window = sim->ra_window < budget ? sim->ra_window : budget;
+            for (int i = 1; i <= window; i++) {
+                prefetch_page(sim, page_number + i, page_number);
+            }
+            sim->stream_next = page_number + window + 1;
+        }
+        break;
+    case PREFETCH_STRIDE:
+        if (!(sim->stride_confirmed && continues)) {
+            long stride = (long)(page_number - sim->last_fault_page);
+            sim->stride_confirmed = (stride != 0 && stride == sim->stride && sim->last_fault_page != ULONG_MAX);
+            sim->stride = stride;
+        }
+        if (sim->stride_confirmed) {
+            for (int i = 1; i <= budget; i++) {
+                prefetch_page(sim, page_number + sim->stride * i, page_number);
+            }
+            sim->stream_next = page_number + sim->stride * (budget + 1);
+        }
+        break;
+    case PREFETCH_MARKOV:
+        // 직전 폴트 페이지의 후속 목록 맨 앞에 현재 페이지를 기록하고, 현재 페이지의 후속 페이지들을 적재
+        if (sim->last_fault_page != ULONG_MAX) {
+            MarkovEntry* previous = markov_slot(sim, sim->last_fault_page);
+            if (previous->page != sim->last_fault_page) {
+                previous->page = sim->last_fault_page;
+                for (int i = 0; i < PREFETCH_MARKOV_WAYS; i++) {
+                    previous->next[i] = ULONG_MAX;
+                }
+            }
+            int position = PREFETCH_MARKOV_WAYS - 1;
+            for (int i = 0; i < PREFETCH_MARKOV_WAYS - 1; i++) {
+                if (previous->next[i] == page_number) {
+                    position = i;
+                }
+            }
+            for (int i = position; i > 0; i--) {
+                previous->next[i] = previous->next[i - 1];
+            }
+            previous->next[0] = page_number;
+        }
+        MarkovEntry* entry = markov_slot(sim, page_number);
+        for (int i = 0; entry->page == page_number && i < PREFETCH_MARKOV_WAYS && i < budget && entry->next[i] != ULONG_MAX; i++) {
+            prefetch_page(sim, entry->next[i], page_number);
+        }
+        break;
+    default:
+        break;
+    }
+    sim->last_fault_page = page_number;
+}
+
+// 가상주소 하나를 처리하는 함수 (페이지 히트면 'H', 페이지 폴트면 'F' 반환)
+// write가 1이면 쓰기 액세스이므로 페이지에 더티 비트를 설정
+char sim_step(Simulator* sim, unsigned long virtual_address, int write) {
+    unsigned long page_number = virtual_address >> sim->page_shift;
+    int frame_number;
+    char page_fault_occurred;
+    PageTableEntry* page_entry = NULL;
+    int tlb_hit = 0;
+
+    // TLB를 먼저 조회 (기본 페이지 TLB 히트면 캐시된 엔트리를 바로 사용)
+    if (sim->tlb_enabled) {
+        int slot = tlb_lookup(&sim->tlb, page_number);
+        if (slot != -1) {
+            page_entry = sim->tlb.entries[slot];
+            tlb_hit = 1;
+        }
+        else if (sim->huge_tlb.sets > 0 && tlb_lookup(&sim->huge_tlb, page_number >> (HUGE_PAGE_SHIFT - sim->page_shift)) != -1) {
+            tlb_hit = 1;
+        }
+        sim->translation_cycles += TLB_HIT_CYCLES;
+    }
+
+    // 페이지 테이블에서 해당 가상 주소의 페이지 번호에 해당하는 엔트리 찾기 (없으면 경로의 노드를 할당)
+    if (page_entry == NULL) {
+        page_entry = page_table_lookup(&sim->page_table, page_number, 1);
+        // huge page 영역에 남아 있지만 적재되지 않은 페이지는 폴트 후 다시 탐색해야 하므로 미스로 처리
+        tlb_hit = tlb_hit && page_entry->valid;
+    }
+    sim->tlb_hits += tlb_hit;
+
+    if (page_entry->valid) {
+        // 페이지가 유효하고, 이미 메모리에 로드되어 있는 경우
+        frame_number = page_entry->frame;
+        page_fault_occurred = 'H'; // 페이지 히트
+
+        // 프리페치로 적재된 페이지의 첫 참조
+        if (page_entry->prefetched) {
+            sim->prefetch.useful++;
+            page_entry->prefetched = 0;
+        }
+
+        // LRU 알고리즘의 경우 참조된 프레임을 리스트의 head로 이동
+        if (sim->algorithm == LRU) {
+            lru_touch(sim, frame_number);
+        }
+
+        // Second-Chance 계열 알고리즘의 경우 reference_bit 업데이트
+        if (sim->algorithm == SECOND_CHANCE || sim->algorithm == ENHANCED_SECOND_CHANCE) {
+            page_entry->reference_bit = 1;
+        }
+
+        // ARC/2Q/CLOCK-Pro/LFU는 각 정책의 리스트 갱신
+        if (sim->algorithm >= ARC) {
+            policy_hit(sim, frame_number);
+        }
+    }
+    else {
+        // 페이지 부재(Page Fault)가 발생한 경우
+        page_fault_occurred = 'F'; // 페이지 폴트
+        sim->page_faults++;
+
+        // 프리페치 때문에 쫓겨났던 페이지면 오염으로 집계
+        if (page_entry->prefetched) {
+            sim->prefetch.polluting_faults++;
+            page_entry->prefetched = 0;
+        }
+        if (sim->prefetcher != PREFETCH_NONE) {
+            prefetch_on_fault(sim, page_number);
+        }
+        frame_number = load_page(sim, page_entry, virtual_address);
+    }
+
+    // 쓰기 액세스면 더티 비트 설정 (새로 적재된 페이지는 release_frame에서 지워진 상태로 시작)
+    page_entry->dirty |= write;
+
+    // TLB 미스면 페이지 테이블 탐색 비용을 더하고 변환 결과를 채움
+    if (sim->tlb_enabled && !tlb_hit) {
+        tlb_fill(sim, page_number, page_entry);
+    }
+
+    // Optimal 알고리즘의 경우 현재 프레임의 다음 사용 시점 갱신
+    if (sim->algorithm == OPTIMAL) {
+        opt_heap_update(sim, frame_number, sim->next_use[sim->access_index]);
+    }
+
+    sim->access_index++;
+    return page_fault_occurred;
+}
+
+// 트레이스 전체(또는 일부 구간)를 처리하는 함수 (이번 구간에서 발생한 페이지 폴트 수 반환)
+// writes가 NULL이면 모든 액세스를 읽기로 처리
+long sim_run(Simulator* sim, const unsigned long* trace, const unsigned char* writes, int count) {
+    long page_faults_before = sim->page_faults;
+    for (int i = 0; i < count; i++) {
+        sim_step(sim, trace[i], writes != NULL && writes[i]);
+    }
+    return sim->page_faults - page_faults_before;
+}
+
+// 다중 프로세스 시뮬레이션
+// PID가 기록된 트레이스에서 프로세스마다 별도의 Simulator(페이지 테이블과 교체 상태)를 두고 물리 프레임을 나누어 사용
+// 균등/비례 분할은 할당이 고정된 지역 교체이고, PFF는 전역 프레임 풀에서 폴트 비율에 따라 할당을 옮김
+// PID → 프로세스 대응은 PageMap으로 찾으므로 프로세스가 수백 개여도 액세스당 O(1)
+
+// 프레임 할당 방식
+typedef enum {
+    ALLOCATION_EQUAL,           // 프레임을 프로세스 수로 균등하게 나눔
+    ALLOCATION_PROPORTIONAL,    // 프로세스가 참조하는 페이지 수(가상 크기)에 비례하여 나눔
+    ALLOCATION_PFF              // 전역 풀에서 페이지 폴트 빈도(PFF)에 따라 재분배
+} FrameAllocation;
+
+const char* allocation_names[] = { "equal", "proportional", "pff" };
+#define ALLOCATION_COUNT 3
+
+#define PFF_DEFAULT_LOWER 0.02      // 폴트 비율이 이보다 낮으면 프레임 회수
+#define PFF_DEFAULT_UPPER 0.10      // 폴트 비율이 이보다 높으면 프레임 추가
+#define PFF_DEFAULT_WINDOW 1000     // 폴트 비율을 재는 구간 (해당 프로세스의 액세스 수)
+
+typedef struct {
+    double lower;
+    double upper;
+    long window;
+} PffConfig;
+
+// 트레이스에 등장하는 프로세스 목록 (처음 등장한 순서)과 프로세스별로 참조한 서로 다른 페이지 수
+typedef struct {
+    int page_shift;
+    int process_count;
+    unsigned long* pids;
+    long* pages;
+} ProcessCensus;
+
+// 트레이스를 한 번 훑어 프로세스 목록을 만드는 함수
+void process_census_build(ProcessCensus* census, const unsigned long* addresses, const unsigned long* pids, int access_count, int page_shift) {
+    PageMap index;              // PID → 프로세스 번호
+    PageMap* page_sets = NULL;  // 프로세스별로 참조한 페이지 집합
+    int capacity = 0;
+
+    memset(census, 0, sizeof(ProcessCensus));
+    census->page_shift = page_shift;
+    page_map_init(&index, 64);
+
+    for (int i = 0; i < access_count; i++) {
+        long* process = page_map_insert(&index, pids[i], -1);
+        if (*process == -1) {
+            if (census->process_count == capacity) {
+                capacity = capacity ? capacity * 2 : 64;
+                census->pids = realloc(census->pids, capacity * sizeof(unsigned long));
+                census->pages = realloc(census->pages, capacity * sizeof(long));
+                page_sets = realloc(page_sets, capacity * sizeof(PageMap));
+            }
+            *process = census->process_count++;
+            census->pids[*process] = pids[i];
+            census->pages[*process] = 0;
+            page_map_init(&page_sets[*process], 64);
+        }
+        long* seen = page_map_insert(&page_sets[*process], addresses[i] >> page_shift, 0);
+        if (*seen == 0) {
+            *seen = 1;
+            census->pages[*process]++;
+        }
+    }
+
+    for (int i = 0; i < census->process_count; i++) {
+        page_map_free(&page_sets[i]);
+    }
+    free(page_sets);
+    page_map_free(&index);
+}
+
+void process_census_free(ProcessCensus* census) {
+    free(census->pids);
+    free(census->pages);
+    memset(census, 0, sizeof(ProcessCensus));
+}
+
+// 프로세스 한 개의 상태
+typedef struct {
+    unsigned long pid;
+    Simulator sim;              // 프로세스의 페이지 테이블과 교체 상태 (sim.num_frames는 받을 수 있는 최대 프레임 수)
+    int* frame_map;             // 프로세스 안의 프레임 번호 → 물리 프레임 번호 (-1이면 아직 배정되지 않음)
+    int allocation;             // 현재 할당된 프레임 수
+    int peak_allocation;        // 가장 많이 할당되었을 때의 프레임 수
+    long accesses;
+    long page_faults;
+    long window_accesses;       // PFF 측정 구간의 액세스 수
+    long window_faults;         // PFF 측정 구간의 폴트 수
+    double last_rate;           // 직전 PFF 구간의 폴트 비율
+} Process;
+
+typedef struct {
+    FrameAllocation allocation;
+    PffConfig pff;
+    int num_frames;             // 전체 물리 프레임 수
+    int page_shift;
+    Process* processes;
+    int process_count;
+    PageMap process_index;      // PID → 프로세스 번호
+    int last_process;           // 직전 액세스의 프로세스 번호 (같은 프로세스가 이어지면 해시 조회 생략)
+    int* free_frames;           // 어느 프로세스에도 배정되지 않은 물리 프레임 스택 (free-frame list)
+    int free_frame_count;
+    int unallocated;            // 어느 프로세스에도 할당되지 않은 프레임 수 (PFF의 전역 풀)
+    long rebalances;            // PFF로 할당을 바꾼 횟수
+} MultiSimulator;
+
+void multi_sim_free(MultiSimulator* multi) {
+    for (int i = 0; i < multi->process_count; i++) {
+        sim_free(&multi->processes[i].sim);
+        free(multi->processes[i].frame_map);
+    }
+    free(multi->processes);
+    free(multi->free_frames);
+    page_map_free(&multi->process_index);
+    memset(multi, 0, sizeof(MultiSimulator));
+}
+
+// 다중 프로세스 시뮬레이터를 초기화하는 함수 (성공 시 0, 설정이 잘못되었으면 -1)
+// 균등 분할은 프레임 수 / 프로세스 수, 비례 분할은 1 + (남는 프레임 × 참조 페이지 수 비율)을 할당 (둘 다 참조 페이지 수가 상한)
+// PFF는 균등 분할에서 시작하여 할당을 바꿔야 하므로 할당을 줄일 수 있는 FIFO/LRU/Second-Chance 계열만 지원
+// Optimal은 미래 참조 정보를 프로세스별로 나누지 않으므로 지원하지 않음
+int multi_sim_init(MultiSimulator* multi, const ProcessCensus* census, Algorithm algorithm, int address_bits, int page_size,
+    long physical_memory_size, FrameAllocation allocation, const PffConfig* pff) {
+    memset(multi, 0, sizeof(MultiSimulator));
+    if (page_size <= 0 || physical_memory_size / page_size > MAX_FRAMES || algorithm == OPTIMAL
+        || (allocation == ALLOCATION_PFF && !sim_supports_frame_limit(algorithm))) {
+        return -1;
+    }
+
+    int num_frames = (int)(physical_memory_size / page_size);
+    int process_count = census->process_count;
+    if (num_frames < process_count) {
+        return -1;
+    }
+
+    long total_pages = 0;
+    for (int i = 0; i < process_count; i++) {
+        total_pages += census->pages[i];
+    }
+
+    multi->allocation = allocation;
+    multi->pff = *pff;
+    multi->num_frames = num_frames;
+    multi->page_shift = census->page_shift;
+    multi->last_process = -1;
+    multi->processes = calloc(process_count > 0 ? process_count : 1, sizeof(Process));
+    page_map_init(&multi->process_index, process_count);
+
+    int assigned = 0;
+    for (int i = 0; i < process_count; i++) {
+        Process* process = &multi->processes[i];
+        int share = (allocation == ALLOCATION_PROPORTIONAL)
+            ? 1 + (int)((double)census->pages[i] * (num_frames - process_count) / total_pages)
+            : num_frames / process_count + (i < num_frames % process_count);
+        if (share > census->pages[i]) {
+            share = (int)census->pages[i]; // 참조하는 페이지보다 많은 프레임은 쓰이지 않음
+        }
+        // PFF는 나중에 늘어날 수 있도록 전체 프레임 수(또는 참조 페이지 수)만큼 준비
+        int capacity = share;
+        if (allocation == ALLOCATION_PFF) {
+            capacity = census->pages[i] < num_frames ? (int)census->pages[i] : num_frames;
+        }
+
+        if (sim_init(&process->sim, algorithm, address_bits, page_size, (long)capacity * page_size) == -1
+            || (allocation == ALLOCATION_PFF && sim_set_frame_limit(&process->sim, share) == -1)) {
+            sim_free(&process->sim);
+            multi_sim_free(multi);
+            return -1;
+        }
+        process->pid = census->pids[i];
+        process->frame_map = malloc(capacity * sizeof(int));
+        for (int j = 0; j < capacity; j++) {
+            process->frame_map[j] = -1;
+        }
+        process->allocation = process->peak_allocation = share;
+        process->last_rate = pff->upper; // 아직 측정하지 않은 프로세스는 프레임을 내줄 후보에서 뒤로 미룸
+        *page_map_insert(&multi->process_index, process->pid, i) = i;
+        multi->process_count++;
+        assigned += share;
+    }
+    multi->unallocated = num_frames - assigned;
+
+    // 물리 프레임 0번부터 배정되도록 스택에 역순으로 넣음
+    multi->free_frames = malloc(num_frames * sizeof(int));
+    for (int i = num_frames - 1; i >= 0; i--) {
+        multi->free_frames[multi->free_frame_count++] = i;
+    }
+    return 0;
+}
+
+// 프로세스의 할당을 바꾸는 함수 (줄이면 쫓겨난 페이지의 물리 프레임을 free list로 돌려줌)
+static void multi_sim_resize(MultiSimulator* multi, Process* process, int allocation) {
+    int freed_before = process->sim.free_frame_count;
+    sim_set_frame_limit(&process->sim, allocation);
+    for (int i = freed_before; i < process->sim.free_frame_count; i++) {
+        int* physical = &process->frame_map[process->sim.free_frames[i]];
+        if (*physical != -1) { // 프리페치된 뒤 한 번도 참조되지 않은 페이지의 프레임은 물리 프레임이 배정되지 않았음
+            multi->free_frames[multi->free_frame_count++] = *physical;
+            *physical = -1;
+        }
+    }
+    process->allocation = allocation;
+    if (allocation > process->peak_allocation) {
+        process->peak_allocation = allocation;
+    }
+}
+
+// PFF: 측정 구간이 끝날 때마다 폴트 비율이 상한보다 높으면 프레임을 더 주고, 하한보다 낮으면 회수하여 전역 풀에 돌려줌
+// 한 번에 할당의 1/8(최소 1)씩 바꾸며, 풀이 부족하면 직전 구간의 폴트 비율이 상한보다 낮은 프로세스 중 가장 낮은 프로세스에게서 가져옴
+static void multi_sim_rebalance(MultiSimulator* multi, Process* process) {
+    double rate = (double)process->window_faults / process->window_accesses;
+    int step = process->allocation / 8 > 1 ? process->allocation / 8 : 1;
+
+    if (rate > multi->pff.upper && process->allocation < process->sim.num_frames) {
+        int wanted = step < process->sim.num_frames - process->allocation ? step : process->sim.num_frames - process->allocation;
+        int granted = wanted < multi->unallocated ? wanted : multi->unallocated;
+        multi->unallocated -= granted;
+
+        if (granted < wanted) {
+            Process* donor = NULL;
+            for (int i = 0; i < multi->process_count; i++) {
+                Process* other = &multi->processes[i];
+                if (other != process && other->allocation > 1 && other->last_rate < multi->pff.upper
+                    && (donor == NULL || other->last_rate < donor->last_rate)) {
+                    donor = other;
+                }
+            }
+            if (donor != NULL) {
+                int taken = wanted - granted < donor->allocation - 1 ? wanted - granted : donor->allocation - 1;
+                multi_sim_resize(multi, donor, donor->allocation - taken);
+                granted += taken;
+            }
+        }
+        if (granted > 0) {
+            multi_sim_resize(multi, process, process->allocation + granted);
+            multi->rebalances++;
+        }
+    }
+    else if (rate < multi->pff.lower && process->allocation > 1) {
+        multi_sim_resize(multi, process, process->allocation - step);
+        multi->unallocated += step;
+        multi->rebalances++;
+    }
+
+    process->last_rate = rate;
+    process->window_accesses = process->window_faults = 0;
+}
+
+// 다중 프로세스 트레이스의 액세스 하나를 처리하는 함수 (페이지 히트면 'H', 페이지 폴트면 'F' 반환)
+// 프로세스의 Simulator로 처리한 뒤, 새로 쓰이기 시작한 프로세스 프레임에는 free list에서 물리 프레임을 배정
+// 트레이스에 있는 PID는 모두 process_census_build로 미리 등록되어 있어야 함
+char multi_sim_step(MultiSimulator* multi, unsigned long pid, unsigned long virtual_address, int write, unsigned long* physical_frame) {
+    if (multi->last_process == -1 || multi->processes[multi->last_process].pid != pid) {
+        multi->last_process = (int)*page_map_find(&multi->process_index, pid);
+    }
+    Process* process = &multi->processes[multi->last_process];
+
+    char page_fault = sim_step(&process->sim, virtual_address, write);
+    int frame = page_table_lookup(&process->sim.page_table, virtual_address >> multi->page_shift, 0)->frame;
+    int* physical = &process->frame_map[frame];
+    if (*physical == -1) {
+        *physical = multi->free_frames[--multi->free_frame_count];
+    }
+    *physical_frame = (unsigned long)*physical;
+
+    process->accesses++;
+    if (page_fault == 'F') {
+        process->page_faults++;
+        process->window_faults++;
+    }
+    if (multi->allocation == ALLOCATION_PFF && ++process->window_accesses == multi->pff.window) {
+        multi_sim_rebalance(multi, process);
+    }
+    return page_fault;
+}
+
+// 쫓겨나며 디스크에 다시 쓴 더티 페이지 수의 전체 합
+long multi_sim_write_backs(const MultiSimulator* multi) {
+    long write_backs = 0;
+    for (int i = 0; i < multi->process_count; i++) {
+        write_backs += multi->processes[i].sim.write_backs;
+    }
+    return write_backs;
+}
+
+// 모든 프로세스의 프리페치를 켜는 함수 (성공 시 0, 설정이 잘못되었으면 -1)
+int multi_sim_enable_prefetch(MultiSimulator* multi, Prefetcher prefetcher, int degree) {
+    for (int i = 0; i < multi->process_count; i++) {
+        if (sim_enable_prefetch(&multi->processes[i].sim, prefetcher, degree) == -1) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// 모든 프로세스의 프리페치 통계를 합치는 함수
+void multi_sim_prefetch_stats(const MultiSimulator* multi, PrefetchStats* total) {
+    memset(total, 0, sizeof(PrefetchStats));
+    for (int i = 0; i < multi->process_count; i++) {
+        const PrefetchStats* stats = &multi->processes[i].sim.prefetch;
+        total->issued += stats->issued;
+        total->useful += stats->useful;
+        total->wasted += stats->wasted;
+        total->polluting_faults += stats->polluting_faults;
+    }
+}
+
+// 프로세스별 결과를 기록하는 함수
+void multi_sim_print(const MultiSimulator* multi, FILE* file) {
+    fprintf(file, "Frame Allocation: %s (%d frames, %d processes", allocation_names[multi->allocation], multi->num_frames, multi->process_count);
+    if (multi->allocation == ALLOCATION_PFF) {
+        fprintf(file, ", %ld rebalances, %d unallocated", multi->rebalances, multi->unallocated);
+    }
+    fprintf(file, ")\n");
+    fprintf(file, "        PID       Accesses    Page Faults   Fault Rate   Write-backs    Frames      Peak\n");
+    for (int i = 0; i < multi->process_count; i++) {
+        const Process* process = &multi->processes[i];
+        fprintf(file, "| %9lu | %12ld | %12ld | %10.6f | %11ld | %7d | %7d |\n", process->pid, process->accesses, process->page_faults,
+            process->accesses ? (double)process->page_faults / process->accesses : 0.0, process->sim.write_backs,
+            process->allocation, process->peak_allocation);
+    }
+}
+
+// Miss Ratio Curve 계산을 위한 Fenwick 트리 (트레이스 위치마다 "해당 페이지의 마지막 참조" 표시를 저장)
+static void fenwick_add(int* tree, int size, int index, int delta) {
+    for (index++; index <= size; index += index & -index) {
+        tree[index] += delta;
+    }
+}
+
+// [0, index) 구간의 합
+static int fenwick_sum(int* tree, int index) {
+    int sum = 0;
+    for (; index > 0; index -= index & -index) {
+        sum += tree[index];
+    }
+    return sum;
+}
+
+#define MRC_MAX_ROWS (1UL << 20) // 가상 페이지 수가 이보다 많으면 참조된 페이지 수까지만 기록
+
+// 트레이스를 한 번 처리하여 모든 프레임 수(1 ~ total_pages)에 대한 LRU/OPT 페이지 폴트 수를 계산하는 함수
+// LRU: Mattson 스택 거리 = 직전 참조 이후 참조된 서로 다른 페이지 수 + 1 (Fenwick 트리로 O(log N))
+// OPT: 다음 사용 시점을 우선순위로 하는 Mattson OPT 스택 알고리즘
+// 스택 거리가 d인 참조는 프레임 수가 d 이상일 때만 히트이므로, 거리 히스토그램의 누적합이 곧 폴트 수가 됨
+// 페이지는 처음 참조된 순서대로 0부터 번호를 다시 매겨 참조된 페이지 수 크기의 배열만 사용
+void compute_miss_ratio_curve(FILE* output_file, const unsigned long* accesses, int access_count, int page_shift, unsigned long total_pages, const int* next_use) {
+    int* page_ids = malloc((access_count + 1) * sizeof(int));
+    PageMap page_id_map;
+    page_map_init(&page_id_map, 1024);
+    for (int t = 0; t < access_count; t++) {
+        page_ids[t] = (int)*page_map_insert(&page_id_map, accesses[t] >> page_shift, (long)page_id_map.count);
+    }
+    int distinct_pages = (int)page_id_map.count;
+    page_map_free(&page_id_map);
+
+    long* lru_hist = calloc(distinct_pages + 2, sizeof(long)); // 거리별 참조 횟수 (인덱스 distinct_pages + 1: 최초 참조)
+    long* opt_hist = calloc(distinct_pages + 2, sizeof(long));
+    int* fenwick = calloc(access_count + 1, sizeof(int));
+    int* last_access = malloc((distinct_pages + 1) * sizeof(int));
+    int* opt_stack = malloc((distinct_pages + 1) * sizeof(int));     // OPT 스택 (0번이 최상단)
+    int* opt_depth = malloc((distinct_pages + 1) * sizeof(int));     // 페이지 → OPT 스택 내 위치 (-1이면 스택에 없음)
+    int* opt_priority = malloc((distinct_pages + 1) * sizeof(int));  // 페이지 → 다음 사용 시점
+    int opt_stack_size = 0;
+
+    for (int i = 0; i < distinct_pages; i++) {
+        last_access[i] = -1;
+        opt_depth[i] = -1;
+    }
+
+    for (int t = 0; t < access_count; t++) {
+        int page_number = page_ids[t];
+
+        // LRU 스택 거리
+        if (last_access[page_number] == -1) {
+            lru_hist[distinct_pages + 1]++;
+        }
+        else {
+            int previous = last_access[page_number];
+            int distance = fenwick_sum(fenwick, t) - fenwick_sum(fenwick, previous + 1) + 1;
+            lru_hist[distance]++;
+            fenwick_add(fenwick, access_count, previous, -1);
+        }
+        fenwick_add(fenwick, access_count, t, 1);
+        last_access[page_number] = t;
+
+        // OPT 스택 갱신: 최상단에 현재 페이지를 놓고, 내려가면서 우선순위가 낮은(더 늦게 사용될) 페이지를 아래로 밀어냄
+        int depth = opt_depth[page_number];
+        if (depth == -1) {
+            opt_hist[distinct_pages + 1]++;
+            opt_stack_size++;
+            depth = opt_stack_size - 1;
+            opt_stack[depth] = page_number;
+        }
+        else {
+            opt_hist[depth + 1]++;
+        }
+
+        int carried = opt_stack[0];
+        opt_stack[0] = page_number;
+        opt_depth[page_number] = 0;
+        if (carried != page_number) {
+            for (int i = 1; i < depth; i++) {
+                int resident = opt_stack[i];
+                if (opt_priority[carried] < opt_priority[resident]) {
+                    opt_stack[i] = carried;
+                    opt_depth[carried] = i;
+                    carried = resident;
+                }
+            }
+            opt_stack[depth] = carried;
+            opt_depth[carried] = depth;
+        }
+        opt_priority[page_number] = next_use[t];
+    }
+
+    fprintf(output_file, "   Frames    LRU Faults    OPT Faults   LRU Miss Ratio   OPT Miss Ratio\n");
+
+    // 프레임 수를 늘려가며 "거리 > 프레임 수"인 참조 수를 누적 계산
+    long lru_faults = access_count;
+    long opt_faults = access_count;
+    unsigned long rows = total_pages <= MRC_MAX_ROWS ? total_pages : (unsigned long)distinct_pages;
+    for (unsigned long frames = 1; frames <= rows; frames++) {
+        if (frames <= (unsigned long)distinct_pages) {
+            lru_faults -= lru_hist[frames];
+            opt_faults -= opt_hist[frames];
+        }
+        fprintf(output_file, "| %6lu | %11ld | %11ld | %14.6f | %14.6f |\n",
+            frames, lru_faults, opt_faults,
+            access_count ? (double)lru_faults / access_count : 0.0,
+            access_count ? (double)opt_faults / access_count : 0.0);
+    }
+
+    free(page_ids);
+    free(lru_hist);
+    free(opt_hist);
+    free(fenwick);
+    free(last_access);
+    free(opt_stack);
+    free(opt_depth);
+    free(opt_priority);
+}
+
+// Working Set 분석 (Denning)
+// W(t, τ): 최근 τ번의 액세스 (t-τ, t]에서 참조된 서로 다른 페이지 수
+// 창 밖에 있던 페이지를 참조하면 Working Set 정책에서는 페이지 폴트이므로, τ마다 평균 W와 폴트 비율을 함께 구하면
+// 프레임 수를 바꿔 가며 다시 시뮬레이션하지 않아도 구간별로 필요한 메모리 양을 알 수 있음
+// 최근 max τ번의 액세스를 링 버퍼에 두고, 각 액세스가 이후에 다시 참조되었는지만 기록하여 τ 하나당 O(1)로 갱신
+#define WS_MAX_WINDOWS 8
+#define WS_DEFAULT_INTERVAL 1000    // 시계열 한 행이 요약하는 액세스 수
+
+typedef struct {
+    int window_count;
+    unsigned long windows[WS_MAX_WINDOWS];  // τ 목록
+    long interval;
+
+    long time;                  // 지금까지 처리한 액세스 수
+    long* next_access;          // 링 버퍼: 액세스 위치 → 같은 페이지의 다음 참조 위치 (-1이면 아직 없음)
+    long ring_size;
+    PageMap last_access;        // 페이지 → 마지막 참조 위치
+
+    long size[WS_MAX_WINDOWS];              // 현재 W(t, τ)
+    long max_size[WS_MAX_WINDOWS];
+    double size_sum[WS_MAX_WINDOWS];
+    long faults[WS_MAX_WINDOWS];
+    double interval_size_sum[WS_MAX_WINDOWS];
+    long interval_faults[WS_MAX_WINDOWS];
+    long interval_max_size[WS_MAX_WINDOWS];
+    FILE* series;               // 시계열 출력 파일 (구간이 끝날 때마다 한 행씩 기록)
+} WorkingSetAnalyzer;
+
+void working_set_init(WorkingSetAnalyzer* ws, const unsigned long* windows, int window_count, long interval, FILE* series) {
+    memset(ws, 0, sizeof(WorkingSetAnalyzer));
+    ws->window_count = window_count;
+    ws->interval = interval;
+    ws->series = series;
+    for (int i = 0; i < window_count; i++) {
+        ws->windows[i] = windows[i];
+        if ((long)windows[i] + 1 > ws->ring_size) {
+            ws->ring_size = (long)windows[i] + 1;
+        }
+    }
+    ws->next_access = malloc(ws->ring_size * sizeof(long));
+    page_map_init(&ws->last_access, 1024);
+
+    fprintf(series, "Working Set Time Series (%ld accesses per row, W: mean/max W(t,tau), F: working set fault rate)\n", interval);
+    fprintf(series, "        Time");
+    for (int i = 0; i < window_count; i++) {
+        fprintf(series, " | %10s%-8lu %8s %8s", "W tau=", windows[i], "max", "F");
+    }
+    fprintf(series, " |\n");
+}
+
+static void working_set_flush_interval(WorkingSetAnalyzer* ws, long length) {
+    fprintf(ws->series, "| %10ld", ws->time);
+    for (int i = 0; i < ws->window_count; i++) {
+        fprintf(ws->series, " | %18.2f %8ld %8.6f", ws->interval_size_sum[i] / length, ws->interval_max_size[i],
+            (double)ws->interval_faults[i] / length);
+        ws->interval_size_sum[i] = 0;
+        ws->interval_faults[i] = 0;
+        ws->interval_max_size[i] = 0;
+    }
+    fprintf(ws->series, " |\n");
+}
+
+// 액세스 하나를 반영하는 함수
+void working_set_step(WorkingSetAnalyzer* ws, unsigned long page_number) {
+    long t = ws->time;
+    long* last = page_map_insert(&ws->last_access, page_number, -1);
+    long previous = *last;
+
+    for (int i = 0; i < ws->window_count; i++) {
+        long tau = (long)ws->windows[i];
+
+        // 창에서 빠지는 액세스 (t - τ): 그 뒤로 다시 참조되지 않았다면 해당 페이지가 창을 떠남
+        if (t - tau >= 0 && ws->next_access[(t - tau) % ws->ring_size] == -1) {
+            ws->size[i]--;
+        }
+        // 직전 참조가 창 밖이면 새로 들어오는 페이지
+        if (previous == -1 || previous <= t - tau) {
+            ws->size[i]++;
+        }
+        // W(t-1, τ)에 없던 페이지를 참조하면 Working Set 정책의 페이지 폴트
+        if (previous == -1 || previous < t - tau) {
+            ws->faults[i]++;
+            ws->interval_faults[i]++;
+        }
+
+        ws->size_sum[i] += ws->size[i];
+        ws->interval_size_sum[i] += ws->size[i];
+        if (ws->size[i] > ws->max_size[i]) {
+            ws->max_size[i] = ws->size[i];
+        }
+        if (ws->size[i] > ws->interval_max_size[i]) {
+            ws->interval_max_size[i] = ws->size[i];
+        }
+    }
+
+    if (previous != -1 && t - previous < ws->ring_size) {
+        ws->next_access[previous % ws->ring_size] = t;
+    }
+    ws->next_access[t % ws->ring_size] = -1;
+    *last = t;
+    ws->time++;
+
+    if (ws->time % ws->interval == 0) {
+        working_set_flush_interval(ws, ws->interval);
+    }
+}
+
+// 남은 구간과 τ별 요약을 기록하고 자원을 정리하는 함수
+void working_set_finish(WorkingSetAnalyzer* ws) {
+    if (ws->time % ws->interval != 0) {
+        working_set_flush_interval(ws, ws->time % ws->interval);
+    }
+
+    fprintf(ws->series, "==================================================================\n");
+    fprintf(ws->series, "Total Number of Accesses: %ld\n", ws->time);
+    fprintf(ws->series, "Distinct Pages: %zu\n", ws->last_access.count);
+    fprintf(ws->series, "       Tau   Mean W(t,tau)    Max W(t,tau)   Fault Rate\n");
+    for (int i = 0; i < ws->window_count; i++) {
+        fprintf(ws->series, "| %9lu | %14.2f | %14ld | %10.6f |\n", ws->windows[i],
+            ws->time ? ws->size_sum[i] / ws->time : 0.0, ws->max_size[i], ws->time ? (double)ws->faults[i] / ws->time : 0.0);
+    }
+
+    free(ws->next_access);
+    page_map_free(&ws->last_access);
+}
+
+// 크기 값을 읽는 함수 (K, M, G 접미사 허용, 실패 시 0)
+static unsigned long parse_size(const char* text) {
+    char* end;
+    unsigned long value = strtoul(text, &end, 10);
+    switch (*end) {
+    case 'K': case 'k': value <<= 10; end++; break;
+    case 'M': case 'm': value <<= 20; end++; break;
+    case 'G': case 'g': value <<= 30; end++; break;
+    }
+    if ((*end == 'B' || *end == 'b') && end != text) {
+        end++;
+    }
+    return (end == text || *end != '\0') ? 0 : value;
+}
+
+// 합성 트레이스 생성기
+// 시드가 같으면 항상 같은 트레이스를 만들며, 파일을 거치지 않고 TraceReader로 바로 시뮬레이터에 공급
+// 모델 명세: "모델[:이름=값,...][@가중치]"를 +로 이어 혼합 (예: zipf:alpha=0.9,pages=4K@0.7+scan:stride=1@0.3)
+//   uniform: pages                          구간 안에서 균등 분포
+//   zipf:    alpha, pages                   순위 k의 페이지를 1/k^alpha에 비례하여 선택 (start에 가까울수록 자주 사용)
+//   phase:   pages, set, length             length번마다 구간 안의 임의 위치로 옮겨 가는 set개 페이지의 작업 집합
+//   scan:    pages, stride                  stride 페이지 간격의 순차 스캔 (구간 끝에서 처음으로 돌아감)
+// 모든 모델은 start(첫 페이지 번호)를 지정할 수 있고, pages를 생략하면 가상주소 공간 전체를 사용
+// write(0 ~ 1)를 지정하면 그 비율만큼 쓰기 액세스를 만듦 (읽기/쓰기 구분이 있는 트레이스가 됨)
+#define GENERATOR_MAX_MODELS 8
+#define GENERATOR_DEFAULT_SET 64
+#define GENERATOR_DEFAULT_LENGTH 10000
+#define GENERATOR_DEFAULT_COUNT 1000000
+
+typedef enum {
+    MODEL_UNIFORM,
+    MODEL_ZIPF,
+    MODEL_PHASE,
+    MODEL_SCAN
+} TraceModelKind;
+
+typedef struct {
+    TraceModelKind kind;
+    double weight;              // 누적 선택 확률 (마지막 모델이 1)
+    unsigned long start;        // 첫 페이지 번호
+    unsigned long pages;        // 페이지 수
+    double write_ratio;         // 쓰기 액세스의 비율 (0이면 모두 읽기)
+
+    // zipf (rejection-inversion 샘플링을 위한 미리 계산한 값)
+    double alpha;
+    double h_integral_x1;
+    double h_integral_n;
+    double s;
+
+    // phase
+    unsigned long set_pages;    // 작업 집합의 페이지 수
+    unsigned long length;       // 한 단계의 액세스 수
+    unsigned long remaining;    // 현재 단계에 남은 액세스 수
+    unsigned long set_base;     // 현재 작업 집합의 첫 페이지 (구간 안의 위치)
+
+    // scan
+    unsigned long stride;
+    unsigned long position;
+} TraceModel;
+
+typedef struct {
+    unsigned long seed;
+    unsigned long state[4];     // xoshiro256** 상태
+    TraceModel models[GENERATOR_MAX_MODELS];
+    int model_count;
+    int page_shift;             // log2(페이지 크기)
+    unsigned long total_pages;  // 가상주소 공간의 페이지 수
+    unsigned long count;        // 생성할 전체 주소 개수
+    unsigned long generated;    // 지금까지 생성한 주소 개수
+    int rw;                     // 1이면 쓰기 비율이 지정된 모델이 있음
+    int last_write;             // 마지막으로 만든 주소가 쓰기 액세스면 1
+} TraceGenerator;
+
+// splitmix64: 시드 하나로 xoshiro 상태를 채우는 데 사용
+static unsigned long splitmix64(unsigned long* x) {
+    unsigned long z = (*x += 0x9E3779B97F4A7C15UL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+    return z ^ (z >> 31);
+}
+
+static unsigned long rotl(unsigned long x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// xoshiro256** 난수 (64bits)
+static unsigned long generator_random(TraceGenerator* gen) {
+    unsigned long* s = gen->state;
+    unsigned long result = rotl(s[1] * 5, 7) * 9;
+    unsigned long t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+// [0, 1) 구간의 실수 난수
+static double generator_uniform(TraceGenerator* gen) {
+    return (generator_random(gen) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// [0, n) 구간의 정수 난수 (곱셈 후 상위 비트를 사용하여 나머지 연산의 편향을 줄임)
+static unsigned long generator_below(TraceGenerator* gen, unsigned long n) {
+    return (unsigned long)(((unsigned __int128)generator_random(gen) * n) >> 64);
+}
+
+// Zipf 샘플링 보조 함수 (Hörmann & Derflinger의 rejection-inversion, x가 0 근처일 때의 정밀도 보정 포함)
+static double zipf_helper1(double x) {
+    return fabs(x) > 1e-8 ? log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+}
+
+static double zipf_helper2(double x) {
+    return fabs(x) > 1e-8 ? expm1(x) / x : 1 + x * 0.5 * (1 + x * (1.0 / 3) * (1 + 0.25 * x));
+}
+
+static double zipf_h(const TraceModel* model, double x) {
+    return exp(-model->alpha * log(x));
+}
+
+static double zipf_h_integral(const TraceModel* model, double x) {
+    double log_x = log(x);
+    return zipf_helper2((1 - model->alpha) * log_x) * log_x;
+}
+
+static double zipf_h_integral_inverse(const TraceModel* model, double x) {
+    double t = x * (1 - model->alpha);
+    if (t < -1) {
+        t = -1;
+    }
+    return exp(zipf_helper1(t) * x);
+}
+
+static void zipf_prepare(TraceModel* model) {
+    model->h_integral_x1 = zipf_h_integral(model, 1.5) - 1;
+    model->h_integral_n = zipf_h_integral(model, model->pages + 0.5);
+    model->s = 2 - zipf_h_integral_inverse(model, zipf_h_integral(model, 2.5) - zipf_h(model, 2));
+}
+
+// 1 ~ pages 중 순위 하나를 뽑는 함수 (평균 반복 횟수가 상수이므로 페이지 수와 관계없이 O(1))
+static unsigned long zipf_sample(TraceGenerator* gen, const TraceModel* model) {
+    while (1) {
+        double u = model->h_integral_n + generator_uniform(gen) * (model->h_integral_x1 - model->h_integral_n);
+        double x = zipf_h_integral_inverse(model, u);
+        double k = floor(x + 0.5);
+        if (k < 1) {
+            k = 1;
+        }
+        else if (k > model->pages) {
+            k = (double)model->pages;
+        }
+        if (k - x <= model->s || u >= zipf_h_integral(model, k + 0.5) - zipf_h(model, k)) {
+            return (unsigned long)k;
+        }
+    }
+}
+
+// 모델 하나의 설정을 읽는 함수 (성공 시 0, 실패 시 -1)
+static int generator_parse_model(TraceGenerator* gen, char* text, TraceModel* model) {
+    char* at = strrchr(text, '@');
+    char* params = strchr(text, ':');
+    char* save;
+
+    memset(model, 0, sizeof(TraceModel));
+    model->weight = 1;
+    model->alpha = 1;
+    model->stride = 1;
+    model->set_pages = GENERATOR_DEFAULT_SET;
+    model->length = GENERATOR_DEFAULT_LENGTH;
+    if (at != NULL) {
+        char* end;
+        *at = '\0';
+        model->weight = strtod(at + 1, &end);
+        if (*end != '\0' || !(model->weight > 0)) {
+            return -1;
+        }
+    }
+    if (params != NULL) {
+        *params++ = '\0';
+    }
+
+    if (strcmp(text, "uniform") == 0) model->kind = MODEL_UNIFORM;
+    else if (strcmp(text, "zipf") == 0) model->kind = MODEL_ZIPF;
+    else if (strcmp(text, "phase") == 0) model->kind = MODEL_PHASE;
+    else if (strcmp(text, "scan") == 0) model->kind = MODEL_SCAN;
+    else return -1;
+
+    for (char* item = params ? strtok_r(params, ",", &save) : NULL; item != NULL; item = strtok_r(NULL, ",", &save)) {
+        char* value = strchr(item, '=');
+        if (value == NULL) {
+            return -1;
+        }
+        *value++ = '\0';
+        if (strcmp(item, "alpha") == 0) {
+            char* end;
+            model->alpha = strtod(value, &end);
+            if (*end != '\0' || !(model->alpha > 0)) {
+                return -1;
+            }
+            continue;
+        }
+        if (strcmp(item, "write") == 0) {
+            char* end;
+            model->write_ratio = strtod(value, &end);
+            if (*end != '\0' || !(model->write_ratio >= 0 && model->write_ratio <= 1)) {
+                return -1;
+            }
+            gen->rw |= model->write_ratio > 0;
+            continue;
+        }
+
+        unsigned long number = parse_size(value);
+        if (strcmp(item, "start") == 0 && strcmp(value, "0") == 0) {
+            continue; // parse_size는 0을 실패로 취급하므로 start=0만 따로 허용
+        }
+        if (number == 0) {
+            return -1;
+        }
+        if (strcmp(item, "pages") == 0) model->pages = number;
+        else if (strcmp(item, "start") == 0) model->start = number;
+        else if (strcmp(item, "set") == 0) model->set_pages = number;
+        else if (strcmp(item, "length") == 0) model->length = number;
+        else if (strcmp(item, "stride") == 0) model->stride = number;
+        else return -1;
+    }
+
+    if (model->pages == 0 || model->pages > gen->total_pages) {
+        model->pages = gen->total_pages;
+    }
+    if (model->set_pages > model->pages) {
+        model->set_pages = model->pages;
+    }
+    if (model->kind == MODEL_ZIPF) {
+        zipf_prepare(model);
+    }
+    return 0;
+}
+
+// 생성기를 처음 상태로 되돌리는 함수 (같은 시드로 같은 트레이스를 다시 생성)
+void trace_generator_reset(TraceGenerator* gen) {
+    unsigned long x = gen->seed;
+    for (int i = 0; i < 4; i++) {
+        gen->state[i] = splitmix64(&x);
+    }
+    for (int i = 0; i < gen->model_count; i++) {
+        gen->models[i].position = 0;
+        gen->models[i].remaining = 0;
+    }
+    gen->generated = 0;
+}
+
+// 모델 명세로 생성기를 초기화하는 함수 (성공 시 0, 명세가 잘못되었으면 -1)
+int trace_generator_init(TraceGenerator* gen, const char* spec, unsigned long seed, unsigned long count, int page_shift, int address_bits) {
+    char buffer[512];
+    char* save;
+    double total_weight = 0;
+
+    memset(gen, 0, sizeof(TraceGenerator));
+    gen->seed = seed;
+    gen->count = count;
+    gen->page_shift = page_shift;
+    gen->total_pages = 1UL << (address_bits - page_shift);
+
+    snprintf(buffer, sizeof(buffer), "%s", spec);
+    for (char* item = strtok_r(buffer, "+", &save); item != NULL; item = strtok_r(NULL, "+", &save)) {
+        if (gen->model_count == GENERATOR_MAX_MODELS || generator_parse_model(gen, item, &gen->models[gen->model_count]) == -1) {
+            return -1;
+        }
+        total_weight += gen->models[gen->model_count++].weight;
+    }
+    if (gen->model_count == 0) {
+        return -1;
+    }
+
+    // 가중치를 누적 확률로 변환
+    double cumulative = 0;
+    for (int i = 0; i < gen->model_count; i++) {
+        cumulative += gen->models[i].weight / total_weight;
+        gen->models[i].weight = cumulative;
+    }
+    gen->models[gen->model_count - 1].weight = 1;
+
+    trace_generator_reset(gen);
+    return 0;
+}
+
+// 다음 가상주소를 만드는 함수 (주소를 만들면 1, 정해진 개수를 모두 만들었으면 0)
+int trace_generator_next(TraceGenerator* gen, unsigned long* address) {
+    if (gen->generated == gen->count) {
+        return 0;
+    }
+    gen->generated++;
+
+    TraceModel* model = &gen->models[0];
+    if (gen->model_count > 1) {
+        double u = generator_uniform(gen);
+        for (int i = 0; u >= model->weight && i < gen->model_count - 1; i++) {
+            model = &gen->models[i + 1];
+        }
+    }
+
+    unsigned long page;
+    switch (model->kind) {
+    case MODEL_ZIPF:
+        page = zipf_sample(gen, model) - 1;
+        break;
+    case MODEL_PHASE:
+        if (model->remaining == 0) {
+            model->set_base = generator_below(gen, model->pages - model->set_pages + 1);
+            model->remaining = model->length;
+        }
+        model->remaining--;
+        page = model->set_base + generator_below(gen, model->set_pages);
+        break;
+    case MODEL_SCAN:
+        page = model->position;
+        model->position = (model->position + model->stride) % model->pages;
+        break;
+    default:
+        page = generator_below(gen, model->pages);
+        break;
+    }
+
+    page = (model->start + page) & (gen->total_pages - 1); // 가상주소 공간을 벗어나면 처음으로 돌아감
+    *address = (page << gen->page_shift) | (generator_random(gen) & ((1UL << gen->page_shift) - 1));
+    gen->last_write = model->write_ratio > 0 && generator_uniform(gen) < model->write_ratio;
+    return 1;
+}
+
+// 가상주소 트레이스 입력기
+// 파일을 mmap으로 매핑한 뒤 직접 파싱하므로 트레이스 길이에 제한이 없고 fscanf 호출 비용이 없음
+// 파이프 등 매핑할 수 없는 입력은 전체를 메모리로 읽어 같은 방식으로 처리
+// generator가 있으면 파일 대신 합성 트레이스 생성기에서 주소를 받음
+typedef struct {
+    const char* data;   // 트레이스 내용
+    size_t size;        // 트레이스 크기 (바이트)
+    size_t pos;         // 다음에 파싱할 위치
+    int mapped;         // 1이면 mmap, 0이면 malloc 버퍼
+
+    // 바이너리 트레이스 전용 정보
+    int binary;                     // 1이면 바이너리 형식
+    int address_bits;               // 헤더에 기록된 가상주소 길이
+    int page_shift;                 // 헤더에 기록된 log2(페이지 크기)
+    unsigned long record_count;     // 헤더에 기록된 전체 레코드 수
+    unsigned int block_remaining;   // 현재 블록에 남은 레코드 수
+    size_t block_end;               // 현재 블록 페이로드의 끝 위치
+    unsigned long records_read;     // 지금까지 디코딩한 레코드 수
+    unsigned long previous_page;    // 차이 계산의 기준이 되는 직전 페이지 번호
+
+    // 다중 프로세스 트레이스 (텍스트는 한 줄에 "PID 가상주소", 바이너리는 PID 플래그)
+    int tagged;                     // 1이면 레코드마다 PID가 있음
+    unsigned long pid;              // 마지막으로 읽은 레코드의 PID (tagged가 0이면 항상 0)
+
+    // 읽기/쓰기 구분 (텍스트는 가상주소 뒤에 R 또는 W, 바이너리는 WRITE 플래그)
+    int rw;                         // 1이면 레코드마다 읽기/쓰기 구분이 있음
+    int write;                      // 마지막으로 읽은 레코드가 쓰기면 1 (rw가 0이면 항상 0)
+
+    TraceGenerator* generator;      // 합성 트레이스 생성기 (소유하지 않음)
+} TraceReader;
+
+// 리틀 엔디언 정수 읽기/쓰기
+static unsigned long read_le(const unsigned char* p, int bytes) {
+    unsigned long value = 0;
+    for (int i = bytes - 1; i >= 0; i--) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+static void write_le(unsigned char* p, unsigned long value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        p[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+// 바이너리 트레이스 헤더를 확인하는 함수 (바이너리가 아니면 0, 헤더가 잘못되었으면 -1)
+static int trace_parse_binary_header(TraceReader* reader) {
+    const unsigned char* p = (const unsigned char*)reader->data;
+
+    if (reader->size < BINARY_TRACE_HEADER_SIZE || memcmp(p, BINARY_TRACE_MAGIC, 4) != 0) {
+        return 0;
+    }
+    if (p[4] != BINARY_TRACE_VERSION || p[6] >= 8 * sizeof(unsigned long) || (p[7] & ~(BINARY_TRACE_FLAG_PID | BINARY_TRACE_FLAG_WRITE)) != 0) {
+        return -1;
+    }
+
+    reader->binary = 1;
+    reader->tagged = (p[7] & BINARY_TRACE_FLAG_PID) != 0;
+    reader->rw = (p[7] & BINARY_TRACE_FLAG_WRITE) != 0;
+    reader->address_bits = p[5];
+    reader->page_shift = p[6];
+    reader->record_count = read_le(p + 12, 8);
+    reader->pos = reader->block_end = BINARY_TRACE_HEADER_SIZE;
+    return 1;
+}
+
+// 텍스트 트레이스의 첫 레코드로 형식을 판단하는 함수
+// 한 줄은 "[PID] 가상주소 [R|W]"이며, 마지막 토큰이 R 또는 W 한 글자이면 읽기/쓰기 구분이 있는 트레이스,
+// 그 토큰을 뺀 숫자가 두 개이면 다중 프로세스 트레이스로 판단
+static void trace_detect_format(TraceReader* reader) {
+    const char* p = reader->data;
+    const char* end = reader->data + reader->size;
+    const char* last = NULL;
+    long last_length = 0;
+    int tokens = 0;
+
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+        p++;
+    }
+    while (p < end && *p != '\n' && *p != '\r') {
+        last = p;
+        tokens++;
+        while (p < end && *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t') {
+            p++;
+        }
+        last_length = p - last;
+        while (p < end && (*p == ' ' || *p == '\t')) {
+            p++;
+        }
+    }
+    reader->rw = tokens >= 2 && last_length == 1 && ((*last | 0x20) == 'r' || (*last | 0x20) == 'w');
+    reader->tagged = tokens - reader->rw >= 2;
+}
+
+void trace_close(TraceReader* reader) {
+    if (reader->mapped) {
+        munmap((void*)reader->data, reader->size);
+    }
+    else {
+        free((void*)reader->data);
+    }
+    reader->data = NULL;
+}
+
+// 트레이스 파일을 여는 함수 (성공 시 0, 실패 시 -1)
+// 파일이 바이너리 트레이스 매직으로 시작하면 바이너리 형식으로, 아니면 텍스트 형식으로 읽음
+int trace_open(TraceReader* reader, const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        return -1;
+    }
+
+    struct stat st;
+    memset(reader, 0, sizeof(TraceReader));
+
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        reader->size = st.st_size;
+        if (reader->size > 0) {
+            void* data = mmap(NULL, reader->size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                close(fd);
+                return -1;
+            }
+            madvise(data, reader->size, MADV_SEQUENTIAL); // 순차 접근이므로 미리 읽기 힌트
+            reader->data = data;
+            reader->mapped = 1;
+        }
+    }
+    else {
+        // 매핑할 수 없는 입력은 끝까지 읽어 버퍼에 저장
+        size_t capacity = 1 << 16;
+        char* buffer = malloc(capacity);
+        ssize_t n;
+        if (buffer == NULL) {
+            close(fd);
+            return -1;
+        }
+        while ((n = read(fd, buffer + reader->size, capacity - reader->size)) != 0) {
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                // 읽기 오류를 트레이스 끝으로 취급하면 잘린 트레이스를 그대로 시뮬레이션하게 됨
+                free(buffer);
+                close(fd);
+                return -1;
+            }
+            reader->size += n;
+            if (reader->size == capacity) {
+                char* grown = realloc(buffer, capacity * 2);
+                if (grown == NULL) {
+                    free(buffer);
+                    close(fd);
+                    return -1;
+                }
+                buffer = grown;
+                capacity *= 2;
+            }
+        }
+        reader->data = buffer;
+    }
+
+    close(fd);
+
+    if (trace_parse_binary_header(reader) == -1) {
+        trace_close(reader);
+        return -1;
+    }
+    if (!reader->binary) {
+        trace_detect_format(reader);
+    }
+    return 0;
+}
+
+// 합성 트레이스 생성기를 트레이스 입력으로 사용하는 함수
+void trace_open_generator(TraceReader* reader, TraceGenerator* generator) {
+    memset(reader, 0, sizeof(TraceReader));
+    reader->generator = generator;
+    reader->rw = generator->rw;
+}
+
+// varint 하나를 읽고 위치를 옮기는 함수 (잘린 레코드면 -1)
+static int read_varint(const unsigned char** position, const unsigned char* end, unsigned long* value) {
+    const unsigned char* p = *position;
+    unsigned long result = 0;
+    int shift = 0;
+    while (1) {
+        if (p == end || shift >= 64) {
+            return -1;
+        }
+        unsigned char byte = *p++;
+        result |= (unsigned long)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+        shift += 7;
+    }
+    *position = p;
+    *value = result;
+    return 1;
+}
+
+// 바이너리 트레이스에서 다음 가상주소를 디코딩하는 함수
+// 매핑된 블록을 복사 없이 그대로 디코딩하며, 주소는 페이지 시작 주소로 복원됨 (페이지 내 오프셋은 저장되지 않음)
+// 레코드는 블록 헤더의 페이로드 크기 안에서만 디코딩하며, 블록의 레코드 수와 페이로드 크기가 맞지 않거나
+// 파일 끝까지 읽은 레코드 수가 헤더의 전체 레코드 수와 다르면 잘못된 형식(-1)으로 처리
+static int trace_next_binary(TraceReader* reader, unsigned long* address) {
+    const unsigned char* p = (const unsigned char*)reader->data + reader->pos;
+    const unsigned char* end = (const unsigned char*)reader->data + reader->size;
+
+    while (reader->block_remaining == 0) {
+        if (reader->pos != reader->block_end) { // 레코드를 모두 읽었는데 페이로드가 남은 블록
+            return -1;
+        }
+        if (p == end) {
+            return reader->records_read == reader->record_count ? 0 : -1;
+        }
+        if (end - p < 8) {
+            return -1;
+        }
+        unsigned long records = read_le(p, 4), payload = read_le(p + 4, 4);
+        if (records == 0 || payload > (unsigned long)(end - p - 8)) {
+            return -1;
+        }
+        reader->block_remaining = (unsigned int)records;
+        reader->previous_page = 0;
+        p += 8;
+        reader->pos = p - (const unsigned char*)reader->data;
+        reader->block_end = reader->pos + payload;
+    }
+    end = (const unsigned char*)reader->data + reader->block_end;
+
+    // PID(varint)와 zig-zag varint 디코딩
+    unsigned long encoded;
+    if (reader->tagged && read_varint(&p, end, &reader->pid) == -1) {
+        return -1;
+    }
+    if (read_varint(&p, end, &encoded) == -1) {
+        return -1;
+    }
+    if (reader->rw) {
+        reader->write = (int)(encoded & 1);
+        encoded >>= 1;
+    }
+    long delta = (long)(encoded >> 1) ^ -(long)(encoded & 1);
+
+    reader->previous_page += delta;
+    reader->block_remaining--;
+    reader->records_read++;
+    reader->pos = p - (const unsigned char*)reader->data;
+    *address = reader->previous_page << reader->page_shift;
+    return 1;
+}
+
+// 텍스트 트레이스에서 숫자 하나를 파싱하는 함수 (10진수 또는 0x로 시작하는 16진수)
+// 숫자를 읽으면 1, 트레이스 끝이면 0, 숫자가 아닌 문자를 만나거나 unsigned long 범위를 넘으면 -1을 반환
+// same_line이 1이면 줄바꿈을 건너뛰지 않음 (PID 뒤의 가상주소가 같은 줄에 없으면 -1)
+static int trace_parse_number(TraceReader* reader, unsigned long* number, int same_line) {
+    const char* p = reader->data + reader->pos;
+    const char* end = reader->data + reader->size;
+
+    // 공백 및 줄바꿈 건너뛰기
+    while (p < end && (*p == ' ' || *p == '\t' || (!same_line && (*p == '\n' || *p == '\r')))) {
+        p++;
+    }
+    if (p == end) {
+        reader->pos = reader->size;
+        return same_line ? -1 : 0;
+    }
+
+    unsigned long value = 0;
+    const char* digits;
+
+    if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        p += 2;
+        digits = p;
+        while (p < end) {
+            unsigned int c = (unsigned char)*p;
+            unsigned int digit;
+            if (c - '0' < 10) {
+                digit = c - '0';
+            }
+            else if ((c | 0x20) - 'a' < 6) {
+                digit = (c | 0x20) - 'a' + 10;
+            }
+            else {
+                break;
+            }
+            if (value > (ULONG_MAX - digit) / 16) { // 범위를 넘는 주소
+                reader->pos = p - reader->data;
+                return -1;
+            }
+            value = (value << 4) | digit;
+            p++;
+        }
+    }
+    else {
+        digits = p;
+        while (p < end && (unsigned int)(*p - '0') < 10) {
+            unsigned long digit = *p - '0';
+            if (value > (ULONG_MAX - digit) / 10) {
+                reader->pos = p - reader->data;
+                return -1;
+            }
+            value = value * 10 + digit;
+            p++;
+        }
+    }
+
+    // 숫자가 하나도 없거나 숫자 뒤에 구분자가 아닌 문자가 붙은 경우
+    if (p == digits || (p < end && *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t')) {
+        reader->pos = p - reader->data;
+        return -1;
+    }
+
+    reader->pos = p - reader->data;
+    *number = value;
+    return 1;
+}
+
+// 가상주소 뒤의 읽기/쓰기 구분(R 또는 W, 대소문자 무관)을 파싱하는 함수 (성공 시 1, 같은 줄에 없거나 잘못되었으면 -1)
+static int trace_parse_access_type(TraceReader* reader) {
+    const char* p = reader->data + reader->pos;
+    const char* end = reader->data + reader->size;
+
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        p++;
+    }
+    if (p == end || ((*p | 0x20) != 'r' && (*p | 0x20) != 'w')
+        || (p + 1 < end && p[1] != ' ' && p[1] != '\n' && p[1] != '\r' && p[1] != '\t')) {
+        reader->pos = p - reader->data;
+        return -1;
+    }
+    reader->write = (*p | 0x20) == 'w';
+    reader->pos = p + 1 - reader->data;
+    return 1;
+}
+
+// 다음 가상주소를 파싱하는 함수 (텍스트 또는 바이너리 레코드, 다중 프로세스 트레이스면 PID는 reader->pid에,
+// 읽기/쓰기 구분이 있으면 쓰기 여부는 reader->write에 기록)
+// 주소를 읽으면 1, 트레이스 끝이면 0, 형식이 잘못되었으면 -1을 반환
+int trace_next(TraceReader* reader, unsigned long* address) {
+    if (reader->generator != NULL) {
+        int status = trace_generator_next(reader->generator, address);
+        reader->write = reader->generator->last_write;
+        return status;
+    }
+    if (reader->binary) {
+        return trace_next_binary(reader, address);
+    }
+
+    int status;
+    if (reader->tagged) {
+        status = trace_parse_number(reader, &reader->pid, 0);
+        if (status == 1) {
+            status = trace_parse_number(reader, address, 1);
+        }
+    }
+    else {
+        status = trace_parse_number(reader, address, 0);
+    }
+    if (status == 1 && reader->rw) {
+        status = trace_parse_access_type(reader);
+    }
+    return status;
+}
+
+// 트레이스를 처음부터 다시 읽도록 하는 함수
+void trace_rewind(TraceReader* reader) {
+    if (reader->generator != NULL) {
+        trace_generator_reset(reader->generator);
+    }
+    reader->pos = reader->block_end = reader->binary ? BINARY_TRACE_HEADER_SIZE : 0;
+    reader->block_remaining = 0;
+    reader->records_read = 0;
+}
+
+// 트레이스에서 읽은 주소를 검사하여 시뮬레이션에 사용할 주소로 변환하는 함수
+// 주소가 가상주소 공간을 벗어나거나 형식이 잘못된 경우 프로그램을 종료
+int trace_next_checked(TraceReader* reader, unsigned long* virtual_address, unsigned long max_virtual_address) {
+    unsigned long address = 0;
+    int status = trace_next(reader, &address);
+
+    if (status == -1) {
+        fprintf(stderr, "입력 파일 형식이 잘못되었습니다. (오프셋 %zu)\n", reader->pos);
+        exit(1);
+    }
+    if (status == 1 && address >= max_virtual_address) {
+        fprintf(stderr, "가상주소 %lu가 가상주소 공간(%lu bytes)을 벗어납니다.\n", address, max_virtual_address);
+        exit(1);
+    }
+
+    *virtual_address = address;
+    return status;
+}
+
+// 부호 없는 값을 varint로 기록하는 함수 (기록한 바이트 수 반환)
+static int write_varint(unsigned char* out, unsigned long value) {
+    int length = 0;
+    while (value >= 0x80) {
+        out[length++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (unsigned char)value;
+    return length;
+}
+
+// 페이지 번호 차이를 zig-zag varint로 기록하는 함수 (기록한 바이트 수 반환)
+static int write_varint_delta(unsigned char* out, long delta) {
+    return write_varint(out, ((unsigned long)delta << 1) ^ (unsigned long)(delta >> 63));
+}
+
+// 텍스트 트레이스와 바이너리 트레이스를 서로 변환하는 함수
+// 사용법: convert <입력 파일> <출력 파일> [페이지 크기(바이트, 기본 1024)]
+// 입력이 텍스트이면 바이너리로, 바이너리이면 텍스트로 변환
+// 바이너리에는 페이지 번호만 저장되므로 변환에 사용한 페이지 크기 이상으로만 시뮬레이션 가능
+// 다중 프로세스 트레이스는 PID를, 읽기/쓰기 구분이 있는 트레이스는 쓰기 여부를 함께 변환
+int convert_trace(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "사용법: convert <입력 파일> <출력 파일> [페이지 크기]\n");
+        return 1;
+    }
+
+    TraceReader reader;
+    if (trace_open(&reader, argv[0]) == -1) {
+        fprintf(stderr, "입력 파일을 열 수 없습니다: %s\n", argv[0]);
+        return 1;
+    }
+
+    FILE* output = fopen(argv[1], "wb");
+    if (output == NULL) {
+        fprintf(stderr, "출력 파일을 생성할 수 없습니다: %s\n", argv[1]);
+        trace_close(&reader);
+        return 1;
+    }
+
+    unsigned long address;
+    int status;
+    int write_error = 0;
+
+    if (reader.binary) {
+        // 바이너리 → 텍스트
+        while ((status = trace_next(&reader, &address)) == 1) {
+            if (reader.tagged) {
+                fprintf(output, "%lu ", reader.pid);
+            }
+            fprintf(output, reader.rw ? "%lu %c\n" : "%lu\n", address, reader.write ? 'W' : 'R');
+        }
+    }
+    else {
+        // 텍스트 → 바이너리
+        unsigned long convert_page_size = argc >= 3 ? strtoul(argv[2], NULL, 10) : 1024;
+        int page_shift = 0;
+        while ((1UL << page_shift) < convert_page_size) {
+            page_shift++;
+        }
+        if (convert_page_size == 0 || (1UL << page_shift) != convert_page_size) {
+            fprintf(stderr, "페이지 크기는 2의 거듭제곱이어야 합니다.\n");
+            fclose(output);
+            trace_close(&reader);
+            return 1;
+        }
+
+        unsigned char header[BINARY_TRACE_HEADER_SIZE] = { 0 };
+        unsigned char* block = malloc(8 + BINARY_TRACE_BLOCK_RECORDS * 20);
+        unsigned long record_count = 0, max_address = 0, previous_page = 0;
+        int block_records = 0, block_bytes = 0;
+
+        if (block == NULL) {
+            fprintf(stderr, "메모리 할당에 실패했습니다.\n");
+            fclose(output);
+            trace_close(&reader);
+            return 1;
+        }
+
+        // 전체 레코드 수를 알 수 없으므로 헤더는 마지막에 다시 기록
+        write_error |= fwrite(header, 1, sizeof(header), output) != sizeof(header);
+
+        while ((status = trace_next(&reader, &address)) == 1) {
+            unsigned long page_number = address >> page_shift;
+            if (reader.tagged) {
+                block_bytes += write_varint(block + 8 + block_bytes, reader.pid);
+            }
+            if (reader.rw) {
+                long delta = (long)(page_number - previous_page);
+                unsigned long encoded = ((unsigned long)delta << 1) ^ (unsigned long)(delta >> 63);
+                block_bytes += write_varint(block + 8 + block_bytes, (encoded << 1) | (unsigned long)reader.write);
+            }
+            else {
+                block_bytes += write_varint_delta(block + 8 + block_bytes, (long)(page_number - previous_page));
+            }
+            previous_page = page_number;
+            if (address > max_address) {
+                max_address = address;
+            }
+            record_count++;
+
+            if (++block_records == BINARY_TRACE_BLOCK_RECORDS) {
+                write_le(block, block_records, 4);
+                write_le(block + 4, block_bytes, 4);
+                write_error |= fwrite(block, 1, 8 + block_bytes, output) != (size_t)(8 + block_bytes);
+                block_records = block_bytes = 0;
+                previous_page = 0;
+            }
+        }
+        if (block_records > 0) {
+            write_le(block, block_records, 4);
+            write_le(block + 4, block_bytes, 4);
+            write_error |= fwrite(block, 1, 8 + block_bytes, output) != (size_t)(8 + block_bytes);
+        }
+        free(block);
+
+        int address_bits = 0;
+        while (address_bits < 64 && (max_address >> address_bits) != 0) {
+            address_bits++;
+        }
+
+        memcpy(header, BINARY_TRACE_MAGIC, 4);
+        header[4] = BINARY_TRACE_VERSION;
+        header[5] = (unsigned char)address_bits;
+        header[6] = (unsigned char)page_shift;
+        header[7] = (reader.tagged ? BINARY_TRACE_FLAG_PID : 0) | (reader.rw ? BINARY_TRACE_FLAG_WRITE : 0);
+        write_le(header + 8, BINARY_TRACE_BLOCK_RECORDS, 4);
+        write_le(header + 12, record_count, 8);
+        if (fseek(output, 0, SEEK_SET) != 0 || fwrite(header, 1, sizeof(header), output) != sizeof(header)) {
+            write_error = 1;
+        }
+    }
+
+    write_error |= ferror(output) != 0;
+    write_error |= fclose(output) != 0;
+    trace_close(&reader);
+
+    if (write_error) {
+        fprintf(stderr, "출력 파일을 쓰는 중 오류가 발생했습니다: %s\n", argv[1]);
+        return 1;
+    }
+    if (status == -1) {
+        fprintf(stderr, "입력 파일 형식이 잘못되었습니다. (오프셋 %zu)\n", reader.pos);
+        return 1;
+    }
+    return 0;
+}
+
+// 디스크 I/O 시간 모델
+// 페이지 폴트마다 페이지 하나를 읽고, 더티 페이지를 쫓아낼 때마다 페이지 하나를 다시 쓰는 것으로 보고 시간을 더함
+// (기본값은 SSD의 4KB 임의 읽기/쓰기 지연 시간 수준)
+#define IO_DEFAULT_READ_US 100.0
+#define IO_DEFAULT_WRITE_US 200.0
+
+typedef struct {
+    int enabled;        // 1이면 쓰기 저장 수와 I/O 시간을 결과에 기록
+    double read_us;     // 페이지 하나를 읽는 시간 (마이크로초)
+    double write_us;    // 더티 페이지 하나를 다시 쓰는 시간 (마이크로초)
+} IoCost;
+
+// 폴트 수와 쓰기 저장 수로 I/O 시간을 계산하는 함수 (밀리초)
+static double io_time_ms(const IoCost* io, long page_faults, long write_backs) {
+    return (page_faults * io->read_us + write_backs * io->write_us) / 1000.0;
+}
+
+// 결과 출력 방식
+typedef enum {
+    OUTPUT_TABLE,   // 액세스마다 표 한 행 (텍스트)
+    OUTPUT_BINARY,  // 액세스마다 고정 크기 바이너리 레코드
+    OUTPUT_SUMMARY  // 폴트 총계와 히트율 히스토그램만 기록
+} OutputMode;
+
+#define OUTPUT_BUFFER_SIZE (1 << 20)    // 표/바이너리 출력 버퍼 크기
+#define OUTPUT_ROW_MAX 192              // 한 행(레코드)의 최대 길이
+#define BINARY_RESULT_RECORD_SIZE 13    // 가상주소(8) + 프레임 번호(4) + 폴트 여부(1)
+#define BINARY_RESULT_PID_SIZE 4        // 다중 프로세스 트레이스는 레코드 앞에 PID(4)를 붙임
+#define HIT_RATE_WINDOW 1000            // 히트율 히스토그램을 위한 구간 길이 (액세스 수)
+#define HIT_RATE_BINS 10                // 히트율 히스토그램 구간 수 (10% 단위)
+
+// 페이지 교체 결과 기록기
+typedef struct {
+    OutputMode mode;
+    FILE* file;
+    char* buffer;           // 표/바이너리 출력을 모아 한 번에 쓰기 위한 버퍼
+    size_t used;
+
+    long accesses;          // 전체 액세스 수
+    long page_faults;       // 전체 페이지 폴트 수
+    long window_accesses;   // 현재 구간의 액세스 수
+    long window_hits;       // 현재 구간의 히트 수
+    long hit_rate_histogram[HIT_RATE_BINS];
+
+    int tlb_enabled;        // 1이면 닫을 때 TLB 통계도 기록
+    long tlb_hits;
+    long translation_cycles;
+
+    IoCost io;              // io.enabled가 1이면 닫을 때 쓰기 저장 수와 I/O 시간도 기록
+    long write_backs;
+
+    Prefetcher prefetcher;  // PREFETCH_NONE이 아니면 닫을 때 프리페치 통계도 기록
+    int prefetch_degree;
+    PrefetchStats prefetch;
+
+    int tagged;                     // 1이면 다중 프로세스 트레이스 (표와 바이너리 레코드에 PID 포함)
+    const MultiSimulator* multi;    // 닫을 때 프로세스별 결과를 기록할 다중 프로세스 시뮬레이터 (없으면 NULL)
+} ResultWriter;
+
+static void result_writer_flush(ResultWriter* writer) {
+    if (writer->used > 0) {
+        fwrite(writer->buffer, 1, writer->used, writer->file);
+        writer->used = 0;
+    }
+}
+
+// 오른쪽 정렬된 10진수를 버퍼에 기록하는 함수 (printf의 "%*lu"와 같은 결과)
+static char* append_padded(char* out, unsigned long value, int width) {
+    char digits[24];
+    int length = 0;
+
+    do {
+        digits[length++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    for (int i = length; i < width; i++) {
+        *out++ = ' ';
+    }
+    while (length > 0) {
+        *out++ = digits[--length];
+    }
+    return out;
+}
+
+static char* append_text(char* out, const char* text) {
+    while (*text) {
+        *out++ = *text++;
+    }
+    return out;
+}
+
+// 결과 기록기를 여는 함수 (표 형식은 헤더를 함께 기록)
+// filename이 NULL이면 파일 없이 폴트 수만 집계, tagged가 1이면 PID 열을 추가
+int result_writer_open(ResultWriter* writer, const char* filename, OutputMode mode, int tagged) {
+    memset(writer, 0, sizeof(ResultWriter));
+    writer->tagged = tagged;
+    if (filename == NULL) {
+        writer->mode = OUTPUT_SUMMARY;
+        return 0;
+    }
+    writer->mode = mode;
+    writer->file = fopen(filename, mode == OUTPUT_BINARY ? "wb" : "w");
+    if (writer->file == NULL) {
+        return -1;
+    }
+
+    if (mode != OUTPUT_SUMMARY) {
+        writer->buffer = malloc(OUTPUT_BUFFER_SIZE);
+    }
+    if (mode == OUTPUT_TABLE) {
+        // 한글 헤더 추가
+        fprintf(writer->file, tagged ? "     NO.        PID      V.A      Page No.   Frame No.      P.A.     Page Fault \n"
+                                     : "     NO.      V.A      Page No.   Frame No.      P.A.     Page Fault \n");
+    }
+    return 0;
+}
+
+// 액세스 하나의 결과를 기록하는 함수 (frame_number는 물리 프레임 번호, pid는 다중 프로세스 트레이스에서만 기록)
+void record_access_result(ResultWriter* writer, int page_shift, unsigned long pid, unsigned long virtual_address,
+    unsigned long frame_number, char page_fault, long count) {
+    unsigned long page_number = virtual_address >> page_shift;
+    unsigned long offset = virtual_address & ((1UL << page_shift) - 1);
+    unsigned long physical_address = (frame_number << page_shift) + offset;
+
+    writer->accesses++;
+    writer->window_accesses++;
+    if (page_fault == 'F') {
+        writer->page_faults++;
+    }
+    else {
+        writer->window_hits++;
+    }
+
+    // 구간이 끝날 때마다 구간 히트율을 히스토그램에 반영
+    if (writer->window_accesses == HIT_RATE_WINDOW) {
+        int bin = (int)(writer->window_hits * HIT_RATE_BINS / writer->window_accesses);
+        writer->hit_rate_histogram[bin < HIT_RATE_BINS ? bin : HIT_RATE_BINS - 1]++;
+        writer->window_accesses = writer->window_hits = 0;
+    }
+
+    if (writer->mode == OUTPUT_SUMMARY) {
+        return;
+    }
+    if (writer->used + OUTPUT_ROW_MAX > OUTPUT_BUFFER_SIZE) {
+        result_writer_flush(writer);
+    }
+
+    char* out = writer->buffer + writer->used;
+
+    if (writer->mode == OUTPUT_TABLE) {
+        // "| %4d | %7d | %10d | %9d | %7d | %12c |\n" 형식을 직접 구성
+        out = append_text(out, "| ");
+        out = append_padded(out, count, 4);
+        out = append_text(out, " | ");
+        if (writer->tagged) {
+            out = append_padded(out, pid, 8);
+            out = append_text(out, " | ");
+        }
+        out = append_padded(out, virtual_address, 7);
+        out = append_text(out, " | ");
+        out = append_padded(out, page_number, 10);
+        out = append_text(out, " | ");
+        out = append_padded(out, frame_number, 9);
+        out = append_text(out, " | ");
+        out = append_padded(out, physical_address, 7);
+        out = append_text(out, " |            ");
+        *out++ = page_fault;
+        out = append_text(out, " |\n");
+    }
+    else {
+        if (writer->tagged) {
+            write_le((unsigned char*)out, pid, BINARY_RESULT_PID_SIZE);
+            out += BINARY_RESULT_PID_SIZE;
+        }
+        write_le((unsigned char*)out, virtual_address, 8);
+        write_le((unsigned char*)out + 8, frame_number, 4);
+        out[12] = page_fault;
+        out += BINARY_RESULT_RECORD_SIZE;
+    }
+
+    writer->used = out - writer->buffer;
+}
+
+// 단일 프로세스 시뮬레이터의 페이지 교체 결과를 기록하는 함수
+void record_page_replacement_result(ResultWriter* writer, Simulator* sim, unsigned long virtual_address, char page_fault, long count) {
+    unsigned long frame_number = page_table_lookup(&sim->page_table, virtual_address >> sim->page_shift, 0)->frame;
+    record_access_result(writer, sim->page_shift, 0, virtual_address, frame_number, page_fault, count);
+}
+
+// TLB 통계 출력 (TLB를 사용한 경우에만)
+static void result_writer_print_tlb(ResultWriter* writer) {
+    if (!writer->tlb_enabled) {
+        return;
+    }
+    fprintf(writer->file, "TLB Hit Rate: %.6f\n", writer->accesses ? (double)writer->tlb_hits / writer->accesses : 0.0);
+    fprintf(writer->file, "Translation Cycles: %ld (%.2f per access)\n", writer->translation_cycles,
+        writer->accesses ? (double)writer->translation_cycles / writer->accesses : 0.0);
+}
+
+// 쓰기 저장 수와 I/O 시간 출력 (I/O 모델을 사용한 경우에만)
+static void result_writer_print_io(ResultWriter* writer) {
+    if (!writer->io.enabled) {
+        return;
+    }
+    fprintf(writer->file, "Write-backs: %ld (%.6f per fault)\n", writer->write_backs,
+        writer->page_faults ? (double)writer->write_backs / writer->page_faults : 0.0);
+    long page_ins = writer->page_faults + writer->prefetch.issued; // 프리페치한 페이지도 디스크에서 읽음
+    fprintf(writer->file, "Modeled I/O Time: %.3f ms (page-in %.3f ms + write-back %.3f ms)\n",
+        io_time_ms(&writer->io, page_ins, writer->write_backs),
+        io_time_ms(&writer->io, page_ins, 0), io_time_ms(&writer->io, 0, writer->write_backs));
+}
+
+// 프리페치 통계 출력 (프리페치를 사용한 경우에만)
+// 정확도 = 유용한 프리페치 / 프리페치한 페이지, 커버리지 = 유용한 프리페치 / (유용한 프리페치 + 남은 요구 폴트)
+// 오염 = 프리페치할 자리를 만들려고 쫓아낸 페이지에서 나중에 다시 난 요구 폴트
+static void result_writer_print_prefetch(ResultWriter* writer) {
+    const PrefetchStats* stats = &writer->prefetch;
+    if (writer->prefetcher == PREFETCH_NONE) {
+        return;
+    }
+    fprintf(writer->file, "Prefetcher: %s (degree %d)\n", prefetcher_names[writer->prefetcher], writer->prefetch_degree);
+    fprintf(writer->file, "Prefetched Pages: %ld (useful %ld, evicted unused %ld)\n", stats->issued, stats->useful, stats->wasted);
+    fprintf(writer->file, "Prefetch Accuracy: %.6f\n", stats->issued ? (double)stats->useful / stats->issued : 0.0);
+    fprintf(writer->file, "Prefetch Coverage: %.6f\n",
+        stats->useful + writer->page_faults ? (double)stats->useful / (stats->useful + writer->page_faults) : 0.0);
+    fprintf(writer->file, "Prefetch Pollution: %ld faults on pages displaced by prefetch\n", stats->polluting_faults);
+    if (writer->io.enabled) {
+        fprintf(writer->file, "Fault Latency Hidden: %.3f ms\n", io_time_ms(&writer->io, stats->useful, 0));
+    }
+}
+
+// 남은 결과를 기록하고 폴트 총계(요약 모드는 히스토그램 포함)를 출력한 뒤 닫는 함수
+void result_writer_close(ResultWriter* writer) {
+    if (writer->file == NULL) {
+        return;
+    }
+    result_writer_flush(writer);
+
+    if (writer->mode == OUTPUT_TABLE) {
+        // 마지막 행 다음에 페이지 폴트의 총 개수를 출력
+        fprintf(writer->file, "==================================================================\n");
+        fprintf(writer->file, "Total Number of Page Faults: %ld\n", writer->page_faults);
+        result_writer_print_tlb(writer);
+        result_writer_print_io(writer);
+        result_writer_print_prefetch(writer);
+        if (writer->multi != NULL) {
+            multi_sim_print(writer->multi, writer->file);
+        }
+    }
+    else if (writer->mode == OUTPUT_SUMMARY) {
+        // 마지막 구간이 남아 있으면 히스토그램에 포함
+        if (writer->window_accesses > 0) {
+            int bin = (int)(writer->window_hits * HIT_RATE_BINS / writer->window_accesses);
+            writer->hit_rate_histogram[bin < HIT_RATE_BINS ? bin : HIT_RATE_BINS - 1]++;
+        }
+
+        fprintf(writer->file, "Total Number of Accesses: %ld\n", writer->accesses);
+        fprintf(writer->file, "Total Number of Page Faults: %ld\n", writer->page_faults);
+        fprintf(writer->file, "Hit Rate: %.6f\n",
+            writer->accesses ? (double)(writer->accesses - writer->page_faults) / writer->accesses : 0.0);
+        result_writer_print_tlb(writer);
+        result_writer_print_io(writer);
+        result_writer_print_prefetch(writer);
+        fprintf(writer->file, "Hit Rate Histogram (%d accesses per window):\n", HIT_RATE_WINDOW);
+        for (int i = 0; i < HIT_RATE_BINS; i++) {
+            fprintf(writer->file, "| %3d%% - %3d%% | %8ld |\n",
+                i * 100 / HIT_RATE_BINS, (i + 1) * 100 / HIT_RATE_BINS, writer->hit_rate_histogram[i]);
+        }
+        if (writer->multi != NULL) {
+            multi_sim_print(writer->multi, writer->file);
+        }
+    }
+
+    fclose(writer->file);
+    free(writer->buffer);
+}
+
+// 시뮬레이션 한 번에 필요한 설정
+typedef struct {
+    int address_bits;           // 가상주소 길이 (bit)
+    int page_size;              // 페이지 크기 (바이트)
+    long physical_memory_size;  // 물리 메모리 크기 (바이트)
+    Algorithm algorithm;
+    int miss_ratio_curve;       // 1이면 Miss Ratio Curve 모드
+    int working_set;            // 1이면 Working Set 분석 모드
+    OutputMode output_mode;
+    const char* output_filename; // NULL이면 결과 파일을 쓰지 않음
+    TlbConfig tlb;              // tlb.entries가 0이면 TLB 모델을 사용하지 않음
+    unsigned long ws_windows[WS_MAX_WINDOWS]; // Working Set 분석의 창 크기(τ) 목록
+    int ws_window_count;
+    long ws_interval;           // Working Set 시계열 한 행의 액세스 수
+    int multi_process;          // 1이면 PID가 기록된 트레이스를 프로세스별로 시뮬레이션
+    FrameAllocation allocation; // 다중 프로세스의 프레임 할당 방식
+    PffConfig pff;
+    IoCost io;                  // 쓰기 저장 수와 I/O 시간을 기록할지 여부 및 비용
+    Prefetcher prefetcher;
+    int prefetch_degree;
+} SimulationConfig;
+
+// 페이지 교체 시뮬레이션을 실행하는 설정인지 여부 (분석 모드가 아닌 경우)
+static int runs_simulator(const SimulationConfig* config) {
+    return !config->miss_ratio_curve && !config->working_set;
+}
+
+// 시뮬레이션 결과
+typedef struct {
+    long accesses;
+    long page_faults;
+    long tlb_hits;
+    long translation_cycles;
+    long write_backs;
+    PrefetchStats prefetch;
+} SimulationResult;
+
+#define LOCKSTEP_CHUNK 4096 // 나란히 실행할 때 한 번에 디코딩하는 트레이스 구간 길이
+
+// 여러 설정의 시뮬레이션을 같은 트레이스에 대해 나란히(lockstep) 실행하는 함수 (성공 시 0, 실패 시 -1)
+// 트레이스를 구간 단위로 한 번만 디코딩하고, 각 구간을 모든 시뮬레이터가 차례로 처리
+// addresses가 NULL이면 reader에서 트레이스를 읽으며 처리하고, 아니면 이미 파싱된 트레이스(다중 프로세스면 pids도,
+// 읽기/쓰기 구분이 있으면 writes도)를 읽기 전용으로 사용
+// (Optimal 알고리즘이나 Miss Ratio Curve 모드가 포함되면 미래 액세스 정보가 필요하므로 트레이스 전체를 배열로 만들고,
+//  다중 프로세스 시뮬레이션은 프로세스 목록을 먼저 알아야 프레임을 나눌 수 있으므로 역시 배열로 만듦)
+int run_simulations(const SimulationConfig* configs, int count, TraceReader* reader, const unsigned long* addresses, const unsigned long* pids,
+    const unsigned char* writes, int access_count, SimulationResult* results) {
+    Simulator* sims = calloc(count, sizeof(Simulator));
+    ResultWriter* writers = calloc(count, sizeof(ResultWriter));
+    WorkingSetAnalyzer* analyzers = calloc(count, sizeof(WorkingSetAnalyzer));
+    MultiSimulator* multis = calloc(count, sizeof(MultiSimulator));
+    int** next_uses = calloc(count, sizeof(int*));
+    unsigned long* future_accesses = NULL;
+    unsigned long* future_pids = NULL;
+    unsigned char* future_writes = NULL;
+    ProcessCensus census;
+    int needs_lookahead = 0;
+    int needs_processes = 0;
+    int initialized = 0;
+    int status = 0;
+    unsigned long max_virtual_address = ULONG_MAX;
+
+    memset(&census, 0, sizeof(census));
+    census.page_shift = -1;
+    for (int i = 0; i < count; i++) {
+        if (configs[i].miss_ratio_curve || configs[i].algorithm == OPTIMAL) {
+            needs_lookahead = 1;
+        }
+        if (configs[i].multi_process) {
+            needs_processes = 1;
+        }
+        if ((1UL << configs[i].address_bits) < max_virtual_address) {
+            max_virtual_address = 1UL << configs[i].address_bits;
+        }
+    }
+
+    // 시뮬레이터 및 출력 파일 준비
+    for (; initialized < count; initialized++) {
+        const SimulationConfig* config = &configs[initialized];
+        if (sim_init(&sims[initialized], config->algorithm, config->address_bits, config->page_size, config->physical_memory_size) == -1) {
+            fprintf(stderr, "시뮬레이션 설정이 잘못되었습니다.\n");
+            status = -1;
+            break;
+        }
+        if (runs_simulator(config) && config->tlb.entries > 0 && sim_enable_tlb(&sims[initialized], &config->tlb) == -1) {
+            fprintf(stderr, "TLB 설정이 잘못되었습니다.\n");
+            sim_free(&sims[initialized]);
+            status = -1;
+            break;
+        }
+        if (runs_simulator(config) && config->prefetcher != PREFETCH_NONE && !config->multi_process
+            && sim_enable_prefetch(&sims[initialized], config->prefetcher, config->prefetch_degree) == -1) {
+            fprintf(stderr, "프리페치 설정이 잘못되었습니다.\n");
+            sim_free(&sims[initialized]);
+            status = -1;
+            break;
+        }
+        if (runs_simulator(config) && result_writer_open(&writers[initialized], config->output_filename, config->output_mode, config->multi_process) == -1) {
+            fprintf(stderr, "출력 파일을 생성할 수 없습니다: %s\n", config->output_filename);
+            sim_free(&sims[initialized]);
+            status = -1;
+            break;
+        }
+        if (config->working_set) {
+            FILE* series = fopen(config->output_filename, "w");
+            if (series == NULL) {
+                fprintf(stderr, "출력 파일을 생성할 수 없습니다: %s\n", config->output_filename);
+                sim_free(&sims[initialized]);
+                status = -1;
+                break;
+            }
+            working_set_init(&analyzers[initialized], config->ws_windows, config->ws_window_count, config->ws_interval, series);
+        }
+    }
 
-// 페이지 테이블
-PageTableEntry* page_table;
+    // 미래 액세스 정보나 프로세스 목록이 필요하면 트레이스 전체를 배열로 만듦
+    if (status == 0 && (needs_lookahead || needs_processes) && addresses == NULL) {
+        int capacity = 1 << 16;
+        unsigned long virtual_address;
+        future_accesses = malloc(capacity * sizeof(unsigned long));
+        if (reader->tagged) {
+            future_pids = malloc(capacity * sizeof(unsigned long));
+        }
+        if (reader->rw) {
+            future_writes = malloc(capacity);
+        }
+        access_count = 0;
+        while (trace_next_checked(reader, &virtual_address, max_virtual_address) == 1) {
+            if (access_count == capacity) {
+                capacity *= 2;
+                future_accesses = realloc(future_accesses, capacity * sizeof(unsigned long));
+                if (future_pids != NULL) {
+                    future_pids = realloc(future_pids, capacity * sizeof(unsigned long));
+                }
+                if (future_writes != NULL) {
+                    future_writes = realloc(future_writes, capacity);
+                }
+            }
+            if (future_pids != NULL) {
+                future_pids[access_count] = reader->pid;
+            }
+            if (future_writes != NULL) {
+                future_writes[access_count] = (unsigned char)reader->write;
+            }
+            future_accesses[access_count++] = virtual_address;
+        }
+        addresses = future_accesses;
+        pids = future_pids;
+        writes = future_writes;
+    }
 
-int page_size; // 페이지 크기를 저장하는 전역 변수
+    // 다중 프로세스 시뮬레이터 준비 (같은 페이지 크기끼리는 프로세스 목록을 한 번만 만듦)
+    for (int i = 0; status == 0 && i < count; i++) {
+        if (!configs[i].multi_process) {
+            continue;
+        }
+        if (pids == NULL) {
+            fprintf(stderr, "다중 프로세스 시뮬레이션에는 PID가 기록된 트레이스가 필요합니다.\n");
+            status = -1;
+            break;
+        }
+        if (census.page_shift != sims[i].page_shift) {
+            process_census_free(&census);
+            process_census_build(&census, addresses, pids, access_count, sims[i].page_shift);
+        }
+        if (multi_sim_init(&multis[i], &census, configs[i].algorithm, configs[i].address_bits, configs[i].page_size,
+                configs[i].physical_memory_size, configs[i].allocation, &configs[i].pff) == -1) {
+            fprintf(stderr, "다중 프로세스 시뮬레이션 설정이 잘못되었습니다. (%s, %s, 프레임 %ld개, 프로세스 %d개)\n",
+                algorithm_names[configs[i].algorithm], allocation_names[configs[i].allocation],
+                configs[i].physical_memory_size / configs[i].page_size, census.process_count);
+            status = -1;
+            break;
+        }
+        if (configs[i].prefetcher != PREFETCH_NONE && multi_sim_enable_prefetch(&multis[i], configs[i].prefetcher, configs[i].prefetch_degree) == -1) {
+            fprintf(stderr, "프리페치 설정이 잘못되었습니다.\n");
+            status = -1;
+            break;
+        }
+        writers[i].multi = &multis[i];
+    }
+    process_census_free(&census);
 
-int physical_memory_size;   // 물리 메모리 크기
+    // 미래 액세스 정보가 필요하면 페이지 크기별로 다음 사용 시점 계산
+    if (status == 0 && needs_lookahead) {
 
-int num_frames;
+        for (int i = 0; i < count; i++) {
+            if (configs[i].miss_ratio_curve || configs[i].algorithm == OPTIMAL) {
+                next_uses[i] = build_next_use(addresses, access_count, sims[i].page_shift);
+                sim_set_next_use(&sims[i], next_uses[i]);
+            }
+        }
+    }
 
-unsigned long max_virtual_address;
+    // Miss Ratio Curve 모드: 트레이스 한 번으로 모든 프레임 수에 대한 결과 기록
+    for (int i = 0; status == 0 && i < count; i++) {
+        if (!configs[i].miss_ratio_curve) {
+            continue;
+        }
+        FILE* output_file = fopen(configs[i].output_filename, "w");
+        if (output_file == NULL) {
+            fprintf(stderr, "출력 파일을 생성할 수 없습니다: %s\n", configs[i].output_filename);
+            status = -1;
+            break;
+        }
+        compute_miss_ratio_curve(output_file, addresses, access_count, sims[i].page_shift, sims[i].total_pages, next_uses[i]);
+        fclose(output_file);
+        results[i].accesses = access_count;
+        results[i].page_faults = 0;
+    }
 
+    // 트레이스를 구간 단위로 모든 시뮬레이터에 적용
+    if (status == 0) {
+        unsigned long chunk[LOCKSTEP_CHUNK];
+        unsigned char chunk_writes[LOCKSTEP_CHUNK];
+        long position = 0; // 지금까지 처리한 가상 주소 개수
 
-// 물리 메모리
-int* physical_memory;
+        while (1) {
+            const unsigned long* block;
+            const unsigned long* block_pids = NULL;
+            const unsigned char* block_writes = NULL;
+            int length = 0;
 
-int front = 0;           // 큐의 프론트 인덱스
+            if (addresses != NULL) {
+                length = access_count - position < LOCKSTEP_CHUNK ? (int)(access_count - position) : LOCKSTEP_CHUNK;
+                block = addresses + position;
+                block_pids = pids != NULL ? pids + position : NULL;
+                block_writes = writes != NULL ? writes + position : NULL;
+            }
+            else {
+                while (length < LOCKSTEP_CHUNK && trace_next_checked(reader, &chunk[length], max_virtual_address) == 1) {
+                    chunk_writes[length++] = (unsigned char)reader->write;
+                }
+                block = chunk;
+                block_writes = reader->rw ? chunk_writes : NULL;
+            }
+            if (length == 0) {
+                break;
+            }
 
-// Optimal 알고리즘에 따라 페이지를 교체하는 함수
-void replace_page_optimal(int virtual_address, int* page_faults, int current_access_index, int* future_accesses) {
-    int longest_unused = -1;
-    int frame_to_replace = -1;
+            for (int i = 0; i < count; i++) {
+                if (configs[i].miss_ratio_curve) {
+                    continue;
+                }
+                if (configs[i].working_set) {
+                    for (int j = 0; j < length; j++) {
+                        working_set_step(&analyzers[i], block[j] >> sims[i].page_shift);
+                    }
+                    continue;
+                }
+                if (configs[i].multi_process) {
+                    for (int j = 0; j < length; j++) {
+                        unsigned long frame_number;
+                        char page_fault_occurred = multi_sim_step(&multis[i], block_pids[j], block[j], block_writes != NULL && block_writes[j], &frame_number);
+                        record_access_result(&writers[i], sims[i].page_shift, block_pids[j], block[j], frame_number, page_fault_occurred, position + j + 1);
+                    }
+                    continue;
+                }
+                for (int j = 0; j < length; j++) {
+                    char page_fault_occurred = sim_step(&sims[i], block[j], block_writes != NULL && block_writes[j]);
 
-    for (int i = 0; i < num_frames; i++) {
-        int found = 0;
-        int future_use_distance = 0;
+                    // 결과 기록
+                    record_page_replacement_result(&writers[i], &sims[i], block[j], page_fault_occurred, position + j + 1);
+                }
+            }
+            position += length;
+        }
 
-        for (int j = current_access_index; j < MAX_FUTURE_ACCESSES; j++) {
-            if (future_accesses[j] / page_size == physical_memory[i] / page_size) {
-                found = 1;
-                future_use_distance = j - current_access_index;
-                break;
+        for (int i = 0; i < count; i++) {
+            if (configs[i].working_set) {
+                results[i].accesses = analyzers[i].time;
+            }
+            else if (!configs[i].miss_ratio_curve) {
+                results[i].accesses = writers[i].accesses;
+                results[i].page_faults = writers[i].page_faults;
+                results[i].tlb_hits = sims[i].tlb_hits;
+                results[i].translation_cycles = sims[i].translation_cycles;
+                results[i].write_backs = configs[i].multi_process ? multi_sim_write_backs(&multis[i]) : sims[i].write_backs;
+                writers[i].tlb_enabled = sims[i].tlb_enabled;
+                writers[i].tlb_hits = sims[i].tlb_hits;
+                writers[i].translation_cycles = sims[i].translation_cycles;
+                if (configs[i].multi_process) {
+                    multi_sim_prefetch_stats(&multis[i], &results[i].prefetch);
+                }
+                else {
+                    results[i].prefetch = sims[i].prefetch;
+                }
+                writers[i].io = configs[i].io;
+                writers[i].write_backs = results[i].write_backs;
+                writers[i].prefetcher = configs[i].prefetcher;
+                writers[i].prefetch_degree = configs[i].prefetch_degree;
+                writers[i].prefetch = results[i].prefetch;
             }
         }
+    }
 
-        if (!found) { // 페이지가 미래에 사용되지 않을 경우
-            frame_to_replace = i;
-            break;
-        } else if (future_use_distance > longest_unused) { // 가장 늦게 사용될 페이지 찾기
-            longest_unused = future_use_distance;
-            frame_to_replace = i;
+    // 파일 및 메모리 자원 정리
+    for (int i = 0; i < initialized; i++) {
+        if (configs[i].working_set) {
+            working_set_finish(&analyzers[i]);
+            fclose(analyzers[i].series);
+        }
+        else if (!configs[i].miss_ratio_curve) {
+            result_writer_close(&writers[i]);
         }
+        sim_free(&sims[i]);
+        multi_sim_free(&multis[i]);
+        free(next_uses[i]);
     }
+    free(sims);
+    free(writers);
+    free(analyzers);
+    free(multis);
+    free(future_pids);
+    free(future_writes);
+    free(next_uses);
+    free(future_accesses);
+
+    return status;
+}
+
+// 파라미터 스윕의 작업 하나 (설정 조합 하나)
+typedef struct {
+    SimulationConfig config;
+    char output_filename[128];
+    SimulationResult result;
+    int status;                 // 0: 성공, -1: 실패
+} SweepJob;
+
+// 스레드 풀이 공유하는 스윕 상태
+// 알고리즘만 다른 작업들은 한 그룹으로 묶어 같은 스레드에서 나란히 실행
+typedef struct {
+    SweepJob* jobs;
+    int group_size;             // 그룹 하나의 작업 수 (알고리즘 수)
+    int group_count;
+    int next_group;             // 다음에 가져갈 그룹 번호 (lock으로 보호)
+    pthread_mutex_t lock;
+    const unsigned long* addresses; // 모든 작업이 읽기 전용으로 공유하는 트레이스
+    const unsigned long* pids;      // 다중 프로세스 트레이스의 PID (없으면 NULL)
+    const unsigned char* writes;    // 액세스별 쓰기 여부 (읽기/쓰기 구분이 없으면 NULL)
+    int access_count;
+    unsigned long max_address;  // 트레이스의 가장 큰 가상주소
+} SweepPool;
 
-    if (frame_to_replace != -1) {
-        int page_number = virtual_address / page_size;
-        int replaced_page = physical_memory[frame_to_replace] / page_size;
-        page_table[replaced_page].valid = 0; // 이전 페이지 무효화
+// 작업 그룹 하나를 나란히 실행하는 함수 (addresses가 NULL이면 reader에서 읽음)
+static void run_sweep_group(SweepJob* group, int group_size, TraceReader* reader, const unsigned long* addresses, const unsigned long* pids,
+    const unsigned char* writes, int access_count) {
+    SimulationConfig* configs = calloc(group_size, sizeof(SimulationConfig));
+    SimulationResult* results = calloc(group_size, sizeof(SimulationResult));
 
-        page_table[page_number].frame = frame_to_replace;
-        page_table[page_number].valid = 1;
-        physical_memory[frame_to_replace] = virtual_address; // 물리 메모리 업데이트
-        (*page_faults)++;
+    for (int i = 0; i < group_size; i++) {
+        configs[i] = group[i].config;
     }
+    int status = run_simulations(configs, group_size, reader, addresses, pids, writes, access_count, results);
+    for (int i = 0; i < group_size; i++) {
+        group[i].result = results[i];
+        group[i].status = status;
+    }
+
+    free(configs);
+    free(results);
 }
 
-// FIFO 페이지 교체 알고리즘
-void replace_page_fifo(int virtual_address, int* page_faults, PageTableEntry* page_table, int* physical_memory) {
+// 그룹을 하나씩 가져가 실행하는 스레드 함수
+static void* sweep_worker(void* arg) {
+    SweepPool* pool = arg;
+
+    while (1) {
+        pthread_mutex_lock(&pool->lock);
+        int index = pool->next_group++;
+        pthread_mutex_unlock(&pool->lock);
+        if (index >= pool->group_count) {
+            break;
+        }
+
+        SweepJob* group = &pool->jobs[index * pool->group_size];
+        if (pool->access_count > 0 && pool->max_address >= (1UL << group->config.address_bits)) {
+            fprintf(stderr, "가상주소 %lu가 %dbits 가상주소 공간을 벗어나 건너뜁니다.\n", pool->max_address, group->config.address_bits);
+            for (int i = 0; i < pool->group_size; i++) {
+                group[i].status = -1;
+            }
+            continue;
+        }
+        run_sweep_group(group, pool->group_size, NULL, pool->addresses, pool->pids, pool->writes, pool->access_count);
+    }
+    return NULL;
+}
 
-    int frame_to_replace;
+// 쉼표로 구분된 값 목록을 읽는 함수 (읽은 개수 반환, 잘못된 값이 있으면 -1)
+// algorithm이 1이면 알고리즘 이름 목록으로 해석
+static int parse_list(const char* text, unsigned long* values, int max_values, int algorithm) {
+    char buffer[256];
+    int count = 0;
 
-    // 페이지 번호 계산
-    int page_number = virtual_address / page_size;
+    snprintf(buffer, sizeof(buffer), "%s", text);
+    for (char* item = strtok(buffer, ","); item != NULL; item = strtok(NULL, ",")) {
+        if (count == max_values) {
+            return -1;
+        }
+        if (algorithm) {
+            int found = -1;
+            for (int i = 0; i < ALGORITHM_COUNT; i++) {
+                if (strcmp(item, algorithm_names[i]) == 0) {
+                    found = i;
+                }
+            }
+            if (strcmp(item, "mrc") == 0) {
+                found = ALGORITHM_COUNT; // Miss Ratio Curve 모드
+            }
+            if (strcmp(item, "ws") == 0) {
+                found = ALGORITHM_COUNT + 1; // Working Set 분석 모드
+            }
+            if (found == -1) {
+                return -1;
+            }
+            values[count++] = found;
+        }
+        else {
+            values[count] = parse_size(item);
+            if (values[count] == 0) {
+                return -1;
+            }
+            count++;
+        }
+    }
+    return count;
+}
 
-    if (front < num_frames) {
-        // 아직 모든 프레임이 할당되지 않았으면 새 프레임 할당
-        frame_to_replace = front;
-        front++;
+// TLB 설정을 읽는 함수 ("엔트리 수[:연관도[:lru|fifo]]", 성공 시 1, 실패 시 -1)
+static int parse_tlb(const char* text, TlbConfig* tlb) {
+    char* end;
+    tlb->entries = (int)strtol(text, &end, 10);
+    tlb->ways = 0;
+    tlb->policy = TLB_LRU;
+    if (*end == ':') {
+        tlb->ways = (int)strtol(end + 1, &end, 10);
+        if (*end == ':') {
+            if (strcmp(end + 1, "lru") == 0) tlb->policy = TLB_LRU;
+            else if (strcmp(end + 1, "fifo") == 0) tlb->policy = TLB_FIFO;
+            else return -1;
+            end += strlen(end);
+        }
     }
-    else {
-        front = 0;
-        frame_to_replace = front;
-        front++;
+    if (*end != '\0' || tlb->entries <= 0 || tlb->ways < 0 || (tlb->ways > 0 && tlb->entries % tlb->ways != 0)) {
+        return -1;
     }
+    return 1;
+}
 
-    int replaced_page = physical_memory[frame_to_replace] / page_size;
-    page_table[replaced_page].valid = 0;
+// 프레임 할당 방식 목록을 읽는 함수 (읽은 개수 반환, 잘못된 이름이 있으면 -1)
+static int parse_allocations(const char* text, FrameAllocation* allocations) {
+    char buffer[256];
+    int count = 0;
 
-    // 페이지 테이블 및 물리 메모리 업데이트
-    page_table[page_number].frame = frame_to_replace;
-    physical_memory[frame_to_replace] = page_number; // 프레임에 페이지 번호를 저장
-    (*page_faults)++;
+    snprintf(buffer, sizeof(buffer), "%s", text);
+    for (char* item = strtok(buffer, ","); item != NULL; item = strtok(NULL, ",")) {
+        int found = -1;
+        for (int i = 0; i < ALLOCATION_COUNT; i++) {
+            if (strcmp(item, allocation_names[i]) == 0) {
+                found = i;
+            }
+        }
+        if (found == -1 || count == ALLOCATION_COUNT) {
+            return -1;
+        }
+        allocations[count++] = (FrameAllocation)found;
+    }
+    return count;
 }
 
-// LRU 알고리즘에 따라 페이지를 교체하는 함수
-void replace_page_lru(int virtual_address, int* page_faults, PageTableEntry* page_table, int* physical_memory, int num_frames, int current_time) {
-    int lruFrame = -1;
-    int minTime = INT_MAX;
+// 프리페치 방식 목록을 읽는 함수 (읽은 개수 반환, 잘못된 이름이 있으면 -1)
+static int parse_prefetchers(const char* text, Prefetcher* prefetchers) {
+    char buffer[256];
+    int count = 0;
 
-    // LRU 프레임 찾기
-    for (int i = 0; i < num_frames; ++i) {
-        int page_index = physical_memory[i] / page_size;
-        if (page_table[page_index].valid && page_table[page_index].last_used <= minTime) {
-            minTime = page_table[page_index].last_used;
-            lruFrame = i;
+    snprintf(buffer, sizeof(buffer), "%s", text);
+    for (char* item = strtok(buffer, ","); item != NULL; item = strtok(NULL, ",")) {
+        int found = -1;
+        for (int i = 0; i < PREFETCHER_COUNT; i++) {
+            if (strcmp(item, prefetcher_names[i]) == 0) {
+                found = i;
+            }
+        }
+        if (found == -1 || count == PREFETCHER_COUNT) {
+            return -1;
         }
+        prefetchers[count++] = (Prefetcher)found;
     }
+    return count;
+}
 
-    // 페이지 교체 수행
-    if (lruFrame != -1) {
-        int page_number = virtual_address / page_size;
-        int replaced_page = physical_memory[lruFrame] / page_size;
-        page_table[replaced_page].valid = 0;  // 이전 페이지 무효화
-
-        page_table[page_number].frame = lruFrame;
-        page_table[page_number].last_used = current_time; // 새 페이지의 last_used 업데이트
-        physical_memory[lruFrame] = page_number * page_size; // 물리 메모리 업데이트
-        (*page_faults)++;
+// I/O 비용을 읽는 함수 ("읽기:쓰기", 마이크로초, 성공 시 1, 실패 시 -1)
+static int parse_io_cost(const char* text, IoCost* io) {
+    char* end;
+    io->read_us = strtod(text, &end);
+    if (*end != ':') {
+        return -1;
     }
+    io->write_us = strtod(end + 1, &end);
+    if (*end != '\0' || io->read_us < 0 || io->write_us < 0) {
+        return -1;
+    }
+    io->enabled = 1;
+    return 1;
 }
 
-// Second-Chance 알고리즘에 따라 페이지를 교체하는 함수
-void replace_page_second_chance(int virtual_address, int* page_faults) {
-    while (1) {
-        int page_index = physical_memory[front] / page_size;
+// PFF 설정을 읽는 함수 ("하한:상한[:구간]", 성공 시 1, 실패 시 -1)
+static int parse_pff(const char* text, PffConfig* pff) {
+    char* end;
+    pff->lower = strtod(text, &end);
+    if (*end != ':') {
+        return -1;
+    }
+    pff->upper = strtod(end + 1, &end);
+    if (*end == ':') {
+        pff->window = (long)parse_size(end + 1);
+        end += strlen(end);
+    }
+    if (*end != '\0' || pff->lower < 0 || pff->upper <= pff->lower || pff->upper > 1 || pff->window <= 0) {
+        return -1;
+    }
+    return 1;
+}
 
-        if (page_table[page_index].reference_bit == 1) {
-            // 참조 비트가 설정된 경우: 참조 비트를 지우고 큐의 뒤로 이동
-            page_table[page_index].reference_bit = 0;
-            front = (front + 1) % num_frames;
-        } else {
-            // 참조 비트가 지워진 페이지를 교체 대상으로 선택
-            int replaced_page = physical_memory[front] / page_size;
-            page_table[replaced_page].valid = 0; // 이전 페이지 무효화
+static void print_usage(const char* program) {
+    fprintf(stderr,
+        "사용법: %s [옵션]          (옵션이 없으면 대화형 모드)\n"
+        "        %s convert <입력 파일> <출력 파일> [페이지 크기]\n"
+        "  -b, --address-bits 목록   가상주소 길이 (bit, 예: 18,19,20)\n"
+        "  -p, --page-size 목록      페이지 크기 (예: 1K,2K,4K)\n"
+        "  -m, --memory 목록         물리 메모리 크기 (예: 32K,64K)\n"
+        "  -a, --algorithm 목록      opt, fifo, lru, sc, esc(Enhanced Second-Chance), arc, 2q, clockpro, lfu, mrc, ws(Working Set 분석)\n"
+        "  -t, --trace 파일          가상주소 트레이스 (텍스트 또는 바이너리)\n"
+        "  -g, --generate 명세       파일 대신 합성 트레이스 사용 (예: zipf:alpha=0.9,pages=4K@0.7+scan:stride=1@0.3)\n"
+        "                            모델: uniform, zipf(alpha), phase(set, length), scan(stride), 공통: pages, start\n"
+        "  -n, --count 개수          생성할 가상주소 개수 (기본: %d)\n"
+        "  -s, --seed 값             생성기 시드 (기본: 1)\n"
+        "  -o, --output 방식         table, binary, summary\n"
+        "  -j, --jobs 개수           스윕에 사용할 스레드 수 (기본: CPU 수)\n"
+        "  -T, --tlb 설정            TLB 엔트리 수[:연관도[:lru|fifo]] (연관도 0: 완전 연관, 예: 64:4:lru)\n"
+        "  -H, --huge-tlb 개수       2MB huge page TLB 엔트리 수 (-T와 함께 사용)\n"
+        "  -w, --walk-cycles 사이클  페이지 테이블 한 단계의 탐색 비용 (기본: %d)\n"
+        "  -W, --ws-windows 목록     Working Set 창 크기 τ (액세스 수, 기본: 100,1K,10K)\n"
+        "  -I, --ws-interval 개수    Working Set 시계열 한 행의 액세스 수 (기본: %d)\n"
+        "  -A, --allocation 목록     PID가 기록된 트레이스의 프레임 할당: equal, proportional, pff (기본: equal)\n"
+        "  -F, --pff 설정            PFF 폴트 비율 하한:상한[:구간] (기본: %.2f:%.2f:%d, pff는 fifo/lru/sc/esc만 지원)\n"
+        "  -C, --io-cost 읽기:쓰기   페이지 읽기/쓰기 시간 (마이크로초, 기본: %.0f:%.0f), 쓰기 저장 수와 I/O 시간을 기록\n"
+        "  -P, --prefetch 목록       폴트 시 프리페치: none, seq(적응형 read-ahead), stride, markov (opt/mrc/ws 제외)\n"
+        "  -d, --prefetch-degree 값  순차 창의 최대 크기 및 stride 프리페치 개수 (기본: %d)\n"
+        "트레이스의 각 줄이 \"PID 가상주소\"이면 프로세스마다 페이지 테이블을 따로 두고 시뮬레이션\n"
+        "가상주소 뒤에 R 또는 W가 있으면(합성 트레이스는 write=비율) 더티 페이지의 쓰기 저장과 I/O 시간을 함께 기록\n"
+        "알고리즘을 여러 개 주면 트레이스 한 번으로 모두 나란히 실행하고,\n"
+        "다른 목록에 값을 여러 개 주면 모든 조합을 스레드 풀에서 동시에 실행 (파라미터 스윕)\n",
+        program, program, GENERATOR_DEFAULT_COUNT, DEFAULT_WALK_CYCLES, WS_DEFAULT_INTERVAL,
+        PFF_DEFAULT_LOWER, PFF_DEFAULT_UPPER, PFF_DEFAULT_WINDOW, IO_DEFAULT_READ_US, IO_DEFAULT_WRITE_US, PREFETCH_DEFAULT_DEGREE);
+}
 
-            int page_number = virtual_address / page_size;
-            page_table[page_number].frame = front;
-            page_table[page_number].valid = 1;
-            physical_memory[front] = virtual_address; // 물리 메모리 업데이트
+// 명령행 인자로 실행하는 함수
+// 알고리즘 외의 설정 조합이 하나이면 트레이스를 읽으며 모든 알고리즘을 나란히 처리하고,
+// 여러 개이면 트레이스를 한 번만 파싱하여 모든 작업이 공유하도록 한 뒤 스레드 풀에서 실행
+int run_command_line(int argc, char* argv[]) {
+    static const struct option options[] = {
+        { "address-bits", required_argument, NULL, 'b' },
+        { "page-size", required_argument, NULL, 'p' },
+        { "memory", required_argument, NULL, 'm' },
+        { "algorithm", required_argument, NULL, 'a' },
+        { "trace", required_argument, NULL, 't' },
+        { "generate", required_argument, NULL, 'g' },
+        { "count", required_argument, NULL, 'n' },
+        { "seed", required_argument, NULL, 's' },
+        { "output", required_argument, NULL, 'o' },
+        { "jobs", required_argument, NULL, 'j' },
+        { "tlb", required_argument, NULL, 'T' },
+        { "huge-tlb", required_argument, NULL, 'H' },
+        { "walk-cycles", required_argument, NULL, 'w' },
+        { "ws-windows", required_argument, NULL, 'W' },
+        { "ws-interval", required_argument, NULL, 'I' },
+        { "allocation", required_argument, NULL, 'A' },
+        { "pff", required_argument, NULL, 'F' },
+        { "io-cost", required_argument, NULL, 'C' },
+        { "prefetch", required_argument, NULL, 'P' },
+        { "prefetch-degree", required_argument, NULL, 'd' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    unsigned long bits[16] = { 18 }, page_sizes[16] = { 1024 }, memories[64] = { 32 * 1024 }, algorithms[ALGORITHM_COUNT + 2] = { LRU };
+    int bits_count = 1, page_size_count = 1, memory_count = 1, algorithm_count = 1;
+    const char* trace_filename = NULL;
+    const char* generator_spec = NULL;
+    unsigned long generate_count = GENERATOR_DEFAULT_COUNT;
+    unsigned long seed = 1;
+    int output_given = 0;
+    OutputMode output_mode = OUTPUT_TABLE;
+    long thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+    TlbConfig tlb = { 0, 0, TLB_LRU, 0, DEFAULT_WALK_CYCLES };
+    unsigned long ws_windows[WS_MAX_WINDOWS] = { 100, 1000, 10000 };
+    int ws_window_count = 3;
+    long ws_interval = WS_DEFAULT_INTERVAL;
+    FrameAllocation allocations[ALLOCATION_COUNT] = { ALLOCATION_EQUAL };
+    int allocation_count = 1, allocation_given = 0;
+    PffConfig pff = { PFF_DEFAULT_LOWER, PFF_DEFAULT_UPPER, PFF_DEFAULT_WINDOW };
+    IoCost io = { 0, IO_DEFAULT_READ_US, IO_DEFAULT_WRITE_US };
+    Prefetcher prefetchers[PREFETCHER_COUNT] = { PREFETCH_NONE };
+    int prefetch_count = 1, prefetch_given = 0;
+    int prefetch_degree = PREFETCH_DEFAULT_DEGREE;
+    int option;
 
-            front = (front + 1) % num_frames; // 큐의 다음 위치로 이동
-            (*page_faults)++;
+    while ((option = getopt_long(argc, argv, "b:p:m:a:t:g:n:s:o:j:T:H:w:W:I:A:F:C:P:d:h", options, NULL)) != -1) {
+        int parsed = 0;
+        switch (option) {
+        case 'b':
+            parsed = bits_count = parse_list(optarg, bits, 16, 0);
+            break;
+        case 'p':
+            parsed = page_size_count = parse_list(optarg, page_sizes, 16, 0);
+            break;
+        case 'm':
+            parsed = memory_count = parse_list(optarg, memories, 64, 0);
+            break;
+        case 'a':
+            parsed = algorithm_count = parse_list(optarg, algorithms, ALGORITHM_COUNT + 2, 1);
+            break;
+        case 't':
+            trace_filename = optarg;
+            parsed = 1;
+            break;
+        case 'g':
+            generator_spec = optarg;
+            parsed = 1;
+            break;
+        case 'n':
+            generate_count = parse_size(optarg);
+            parsed = generate_count > 0 ? 1 : -1;
+            break;
+        case 's': {
+            char* end;
+            seed = strtoul(optarg, &end, 0);
+            parsed = (*end == '\0' && end != optarg) ? 1 : -1;
+            break;
+        }
+        case 'o':
+            output_given = parsed = 1;
+            if (strcmp(optarg, "table") == 0) output_mode = OUTPUT_TABLE;
+            else if (strcmp(optarg, "binary") == 0) output_mode = OUTPUT_BINARY;
+            else if (strcmp(optarg, "summary") == 0) output_mode = OUTPUT_SUMMARY;
+            else parsed = -1;
+            break;
+        case 'j':
+            thread_count = strtol(optarg, NULL, 10);
+            parsed = thread_count > 0 ? 1 : -1;
+            break;
+        case 'T':
+            parsed = parse_tlb(optarg, &tlb);
             break;
+        case 'H':
+            tlb.huge_entries = (int)strtol(optarg, NULL, 10);
+            parsed = tlb.huge_entries > 0 ? 1 : -1;
+            break;
+        case 'w':
+            tlb.walk_cycles = (int)strtol(optarg, NULL, 10);
+            parsed = tlb.walk_cycles > 0 ? 1 : -1;
+            break;
+        case 'W':
+            parsed = ws_window_count = parse_list(optarg, ws_windows, WS_MAX_WINDOWS, 0);
+            break;
+        case 'I':
+            ws_interval = (long)parse_size(optarg);
+            parsed = ws_interval > 0 ? 1 : -1;
+            break;
+        case 'A':
+            allocation_given = 1;
+            parsed = allocation_count = parse_allocations(optarg, allocations);
+            break;
+        case 'F':
+            parsed = parse_pff(optarg, &pff);
+            break;
+        case 'C':
+            parsed = parse_io_cost(optarg, &io);
+            break;
+        case 'P':
+            prefetch_given = 1;
+            parsed = prefetch_count = parse_prefetchers(optarg, prefetchers);
+            break;
+        case 'd':
+            prefetch_degree = (int)strtol(optarg, NULL, 10);
+            parsed = prefetch_degree > 0 ? 1 : -1;
+            break;
+        default:
+            print_usage(argv[0]);
+            return option == 'h' ? 0 : 1;
+        }
+        if (parsed <= 0) {
+            fprintf(stderr, "잘못된 옵션 값입니다: -%c %s\n", option, optarg);
+            return 1;
         }
     }
-}
 
-int handle_virtual_address(int virtual_address, int* page_faults, int* current_frame, Algorithm algorithm, char* page_fault_occurred, int current_access_index, int* future_accesses, int* current_time) {
-    int page_number = virtual_address / page_size;
-    int frame_number;
-
-    // 페이지 테이블에서 해당 가상 주소의 페이지 번호에 해당하는 엔트리 찾기
-    PageTableEntry* page_entry = &page_table[page_number];
+    if ((trace_filename == NULL) == (generator_spec == NULL) || optind != argc) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (tlb.huge_entries > 0 && tlb.entries == 0) {
+        fprintf(stderr, "huge page TLB는 -T로 TLB를 지정한 경우에만 사용할 수 있습니다.\n");
+        return 1;
+    }
 
-    if (page_entry->valid) {
-        // 페이지가 유효하고, 이미 메모리에 로드되어 있는 경우
-        frame_number = page_entry->frame;
-        *page_fault_occurred = 'H'; // 페이지 히트
+    // 설정 값 검사
+    for (int i = 0; i < bits_count; i++) {
+        if (bits[i] < 10 || bits[i] > 57) {
+            fprintf(stderr, "가상주소 길이는 10에서 57 bits 사이여야 합니다.\n");
+            return 1;
+        }
+    }
+    for (int i = 0; i < page_size_count; i++) {
+        if ((page_sizes[i] & (page_sizes[i] - 1)) != 0 || page_sizes[i] > (1UL << 20)) {
+            fprintf(stderr, "페이지 크기는 1MB 이하의 2의 거듭제곱이어야 합니다.\n");
+            return 1;
+        }
+    }
+    for (int i = 0; i < memory_count; i++) {
+        for (int j = 0; j < page_size_count; j++) {
+            if (memories[i] / page_sizes[j] > MAX_FRAMES) {
+                fprintf(stderr, "물리 프레임 수는 %lu개 이하여야 합니다.\n", (unsigned long)MAX_FRAMES);
+                return 1;
+            }
+        }
+    }
 
-        // LRU 알고리즘의 경우 last_used 업데이트
-        if (algorithm == LRU) {
-            page_table[page_number].last_used = *current_time;
+    // 합성 트레이스는 가장 작은 페이지 크기와 가장 짧은 가상주소 길이에 맞춰 생성하여 모든 조합에서 사용할 수 있게 함
+    TraceReader input_trace;
+    TraceGenerator generator;
+    if (generator_spec != NULL) {
+        unsigned long min_page_size = page_sizes[0];
+        unsigned long min_bits = bits[0];
+        int page_shift = 0;
+        for (int i = 1; i < page_size_count; i++) {
+            min_page_size = page_sizes[i] < min_page_size ? page_sizes[i] : min_page_size;
+        }
+        for (int i = 1; i < bits_count; i++) {
+            min_bits = bits[i] < min_bits ? bits[i] : min_bits;
+        }
+        while ((1UL << page_shift) < min_page_size) {
+            page_shift++;
         }
+        if (page_shift > (int)min_bits || trace_generator_init(&generator, generator_spec, seed, generate_count, page_shift, (int)min_bits) == -1) {
+            fprintf(stderr, "생성 모델 명세가 잘못되었습니다: %s\n", generator_spec);
+            return 1;
+        }
+        trace_open_generator(&input_trace, &generator);
+    }
+    else if (trace_open(&input_trace, trace_filename) == -1) {
+        fprintf(stderr, "입력 파일을 열 수 없습니다: %s\n", trace_filename);
+        return 1;
+    }
 
-        // Second-Chance 알고리즘의 경우 reference_bit 업데이트
-        if (algorithm == SECOND_CHANCE) {
-            page_table[page_number].reference_bit = 1;
+    // 바이너리 트레이스는 기록된 페이지 크기보다 작은 페이지로는 시뮬레이션할 수 없음
+    for (int i = 0; i < page_size_count; i++) {
+        if (input_trace.binary && (1UL << input_trace.page_shift) > page_sizes[i]) {
+            fprintf(stderr, "바이너리 트레이스의 페이지 크기(%lu)가 페이지 크기 %lu보다 큽니다.\n", 1UL << input_trace.page_shift, page_sizes[i]);
+            trace_close(&input_trace);
+            return 1;
         }
     }
-    else {
-        // 페이지 부재(Page Fault)가 발생한 경우
-        *page_fault_occurred = 'F'; // 페이지 폴트
-        (*page_faults)++;
-        page_entry->valid = 1; // 페이지 엔트리를 유효하게 설정
 
-        if (*current_frame < num_frames) {
-            // 물리 메모리에 여유가 있는 경우
-            frame_number = *current_frame;
-            // Second-Chance 알고리즘의 경우 reference_bit 설정
-            if (algorithm == SECOND_CHANCE) {
-                page_table[page_number].reference_bit = 1;
+    // PID가 기록된 트레이스는 프로세스별로 시뮬레이션 (미래 참조가 필요한 모드와 TLB 모델은 단일 프로세스 전용)
+    int tagged = input_trace.tagged;
+    const char* multi_error = NULL;
+    if (allocation_given && !tagged) {
+        multi_error = "프레임 할당 방식은 PID가 기록된 트레이스에서만 지정할 수 있습니다.";
+    }
+    for (int a = 0; tagged && a < algorithm_count; a++) {
+        if (algorithms[a] == OPTIMAL || algorithms[a] >= ALGORITHM_COUNT) {
+            multi_error = "PID가 기록된 트레이스는 opt, mrc, ws를 지원하지 않습니다.";
+        }
+        for (int k = 0; k < allocation_count; k++) {
+            if (allocations[k] == ALLOCATION_PFF && !sim_supports_frame_limit((Algorithm)algorithms[a])) {
+                multi_error = "pff 할당은 fifo, lru, sc, esc 알고리즘에서만 사용할 수 있습니다.";
             }
         }
-        else {
-            // 물리 메모리에 여유가 없어 페이지 교체가 필요한 경우
-            switch (algorithm) {
-            case OPTIMAL:
-                replace_page_optimal(virtual_address, page_faults, current_access_index, future_accesses);
-                break;
-            case FIFO:
-                replace_page_fifo(virtual_address, page_faults, page_table, physical_memory);
-                break;
-            case LRU:
-                replace_page_lru(virtual_address, page_faults, page_table, physical_memory, num_frames, *current_time);
-                break;
-            case SECOND_CHANCE:
-                replace_page_second_chance(virtual_address, page_faults);
-                break;
-            default:
-                fprintf(stderr, "알 수 없는 페이지 교체 알고리즘입니다.\n");
-                exit(1);
+    }
+    if (tagged && tlb.entries > 0) {
+        multi_error = "TLB 모델은 PID가 기록된 트레이스에서 사용할 수 없습니다.";
+    }
+    // 프리페치 페이지는 미래 참조 정보가 없고, 분석 모드는 페이지를 적재하지 않으므로 opt, mrc, ws와 함께 쓸 수 없음
+    for (int f = 0; f < prefetch_count; f++) {
+        for (int a = 0; prefetchers[f] != PREFETCH_NONE && a < algorithm_count; a++) {
+            if (algorithms[a] == OPTIMAL || algorithms[a] >= ALGORITHM_COUNT) {
+                multi_error = "프리페치는 opt, mrc, ws와 함께 사용할 수 없습니다.";
             }
-            frame_number = page_entry->frame; // 교체 후에 새로운 페이지의 프레임 번호를 가져옴
         }
+    }
+    if (multi_error != NULL) {
+        fprintf(stderr, "%s\n", multi_error);
+        trace_close(&input_trace);
+        return 1;
+    }
+    if (!tagged) {
+        allocation_count = 1;
+    }
+    io.enabled |= input_trace.rw; // 읽기/쓰기 구분이 있는 트레이스는 항상 쓰기 저장 수를 기록
+
+    // 모든 설정 조합 생성
+    int job_count = bits_count * page_size_count * memory_count * allocation_count * prefetch_count * algorithm_count;
+    int group_count = job_count / algorithm_count;
+    SweepJob* jobs = calloc(job_count, sizeof(SweepJob));
+    int sweep = group_count > 1;
+    int job_index = 0;
+
+    for (int b = 0; b < bits_count; b++) {
+        for (int p = 0; p < page_size_count; p++) {
+            for (int m = 0; m < memory_count; m++) {
+                for (int k = 0; k < allocation_count; k++) {
+                    for (int f = 0; f < prefetch_count; f++) {
+                        for (int a = 0; a < algorithm_count; a++) {
+                            SweepJob* job = &jobs[job_index++];
+                            int mrc = (algorithms[a] == ALGORITHM_COUNT);
+                            int ws = (algorithms[a] == ALGORITHM_COUNT + 1);
+                            int analysis = mrc || ws; // 분석 모드는 항상 표 형식의 결과 파일을 씀
+                            const char* name = mrc ? "mrc" : ws ? "ws" : algorithm_names[algorithms[a]];
 
-        page_table[page_number].frame = frame_number;
-        physical_memory[frame_number] = virtual_address;
-        (*current_frame)++;
+                            job->config.address_bits = (int)bits[b];
+                            job->config.page_size = (int)page_sizes[p];
+                            job->config.physical_memory_size = (long)memories[m];
+                            job->config.algorithm = mrc ? OPTIMAL : ws ? FIFO : (Algorithm)algorithms[a];
+                            job->config.miss_ratio_curve = mrc;
+                            job->config.working_set = ws;
+                            job->config.output_mode = output_mode;
+                            job->config.tlb = tlb;
+                            memcpy(job->config.ws_windows, ws_windows, sizeof(ws_windows));
+                            job->config.ws_window_count = ws_window_count;
+                            job->config.ws_interval = ws_interval;
+                            job->config.multi_process = tagged;
+                            job->config.allocation = allocations[k];
+                            job->config.pff = pff;
+                            job->config.io = io;
+                            job->config.prefetcher = prefetchers[f];
+                            job->config.prefetch_degree = prefetch_degree;
+
+                            // 스윕에서는 설정 값을 파일 이름에 붙여 구분 (출력 방식을 지정하지 않으면 결과 파일 없이 집계만)
+                            if (sweep) {
+                                snprintf(job->output_filename, sizeof(job->output_filename), "output.%s.%lub.%lu.%lu%s%s%s%s%s",
+                                    name, bits[b], page_sizes[p], memories[m], tagged ? "." : "", tagged ? allocation_names[allocations[k]] : "",
+                                    prefetch_given ? "." : "", prefetch_given ? prefetcher_names[prefetchers[f]] : "",
+                                    output_mode == OUTPUT_BINARY && !analysis ? ".bin" : "");
+                            }
+                            else {
+                                snprintf(job->output_filename, sizeof(job->output_filename), "output.%s%s",
+                                    name, output_mode == OUTPUT_BINARY && !analysis ? ".bin" : "");
+                            }
+                            job->config.output_filename = (!sweep || output_given || analysis) ? job->output_filename : NULL;
+
+                            if (job->config.physical_memory_size < job->config.page_size) {
+                                fprintf(stderr, "물리 메모리 크기는 페이지 크기 이상이어야 합니다.\n");
+                                free(jobs);
+                                trace_close(&input_trace);
+                                return 1;
+                            }
+                        }
+                    }
+                }
+            }
+        }
     }
 
-    // 페이지 액세스마다 시간 증가
-    (*current_time)++;
+    int status = 0;
 
-    return *page_faults;
-}
+    if (!sweep) {
+        // 알고리즘만 다르면 트레이스를 읽으면서 모든 알고리즘을 나란히 실행
+        run_sweep_group(jobs, algorithm_count, &input_trace, NULL, NULL, NULL, 0);
+    }
+    else {
+        // 트레이스를 한 번만 파싱하여 모든 작업이 공유
+        SweepPool pool;
+        int capacity = 1 << 16;
+        unsigned long address;
+        int parse_status;
+
+        memset(&pool, 0, sizeof(pool));
+        unsigned long* addresses = malloc(capacity * sizeof(unsigned long));
+        unsigned long* pids = tagged ? malloc(capacity * sizeof(unsigned long)) : NULL;
+        unsigned char* writes = input_trace.rw ? malloc(capacity) : NULL;
+        while ((parse_status = trace_next(&input_trace, &address)) == 1) {
+            if (pool.access_count == capacity) {
+                capacity *= 2;
+                addresses = realloc(addresses, capacity * sizeof(unsigned long));
+                if (pids != NULL) {
+                    pids = realloc(pids, capacity * sizeof(unsigned long));
+                }
+                if (writes != NULL) {
+                    writes = realloc(writes, capacity);
+                }
+            }
+            if (pids != NULL) {
+                pids[pool.access_count] = input_trace.pid;
+            }
+            if (writes != NULL) {
+                writes[pool.access_count] = (unsigned char)input_trace.write;
+            }
+            addresses[pool.access_count++] = address;
+            if (address > pool.max_address) {
+                pool.max_address = address;
+            }
+        }
+        if (parse_status == -1) {
+            fprintf(stderr, "입력 파일 형식이 잘못되었습니다. (오프셋 %zu)\n", input_trace.pos);
+            free(addresses);
+            free(pids);
+            free(writes);
+            free(jobs);
+            trace_close(&input_trace);
+            return 1;
+        }
 
-// 페이지 교체 결과를 기록하는 함수
-void record_page_replacement_result(FILE* output_file, int virtual_address, int page_faults, char page_fault, int count, int page_fault_count) {
-    int page_number = virtual_address / page_size; // 전역 변수 page_size 사용
-    int frame_number = page_table[page_number].frame;
-    int offset = virtual_address % page_size; // 전역 변수 page_size 사용
-    int physical_address = frame_number * page_size + offset; // 전역 변수 page_size 사용
+        pool.jobs = jobs;
+        pool.group_size = algorithm_count;
+        pool.group_count = group_count;
+        pool.addresses = addresses;
+        pool.pids = pids;
+        pool.writes = writes;
+        pthread_mutex_init(&pool.lock, NULL);
 
-    fprintf(output_file, "| %4d | %7d | %10d | %9d | %7d | %12c |\n",
-        count, virtual_address, page_number, frame_number, physical_address, page_fault);
+        if (thread_count > group_count) {
+            thread_count = group_count;
+        }
+        pthread_t* threads = malloc(thread_count * sizeof(pthread_t));
+        for (long i = 0; i < thread_count; i++) {
+            pthread_create(&threads[i], NULL, sweep_worker, &pool);
+        }
+        for (long i = 0; i < thread_count; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        free(threads);
+        pthread_mutex_destroy(&pool.lock);
+        free(addresses);
+        free(pids);
+        free(writes);
+    }
 
-    // 마지막 행에서 페이지 폴트의 총 개수를 출력
-    if (count == 5000) {
-        fprintf(output_file, "==================================================================\n");
-        fprintf(output_file, "Total Number of Page Faults: %d\n", page_fault_count);
+    // 결과 요약 출력
+    printf("  Bits   Page Size      Memory  Algorithm      Accesses   Page Faults    Hit Rate%s%s%s%s\n",
+        tlb.entries > 0 ? "  TLB Hit Rate  Cycles/Access" : "", io.enabled ? "   Write-backs   I/O Time(ms)" : "",
+        prefetch_given ? "  Prefetcher   Prefetched   Accuracy   Coverage   Pollution" : "", tagged ? "    Allocation" : "");
+    for (int i = 0; i < job_count; i++) {
+        SweepJob* job = &jobs[i];
+        const char* name = job->config.miss_ratio_curve ? "mrc" : job->config.working_set ? "ws" : algorithm_names[job->config.algorithm];
+        printf("| %4d | %9d | %9ld | %9s | ", job->config.address_bits, job->config.page_size, job->config.physical_memory_size, name);
+        if (job->status != 0) {
+            printf("%11s | %11s | %9s |%s%s", "ERROR", "-", "-", tlb.entries > 0 ? "            - |             - |" : "",
+                io.enabled ? "           - |              - |" : "");
+            if (prefetch_given) {
+                printf(" %10s | %10s | %8s | %8s | %9s |", prefetcher_names[job->config.prefetcher], "-", "-", "-", "-");
+            }
+            status = -1;
+        }
+        else if (!runs_simulator(&job->config)) {
+            printf("%11ld | %11s | %9s |%s%s", job->result.accesses, job->output_filename, "-", tlb.entries > 0 ? "            - |             - |" : "",
+                io.enabled ? "           - |              - |" : "");
+            if (prefetch_given) {
+                printf(" %10s | %10s | %8s | %8s | %9s |", prefetcher_names[job->config.prefetcher], "-", "-", "-", "-");
+            }
+        }
+        else {
+            printf("%11ld | %11ld | %9.6f |", job->result.accesses, job->result.page_faults,
+                job->result.accesses ? (double)(job->result.accesses - job->result.page_faults) / job->result.accesses : 0.0);
+            if (tlb.entries > 0) {
+                printf(" %12.6f | %13.2f |", job->result.accesses ? (double)job->result.tlb_hits / job->result.accesses : 0.0,
+                    job->result.accesses ? (double)job->result.translation_cycles / job->result.accesses : 0.0);
+            }
+            if (io.enabled) {
+                printf(" %11ld | %14.3f |", job->result.write_backs,
+                    io_time_ms(&io, job->result.page_faults + job->result.prefetch.issued, job->result.write_backs));
+            }
+            if (prefetch_given) {
+                const PrefetchStats* stats = &job->result.prefetch;
+                printf(" %10s | %10ld | %8.4f | %8.4f | %9ld |", prefetcher_names[job->config.prefetcher], stats->issued,
+                    stats->issued ? (double)stats->useful / stats->issued : 0.0,
+                    stats->useful + job->result.page_faults ? (double)stats->useful / (stats->useful + job->result.page_faults) : 0.0,
+                    stats->polluting_faults);
+            }
+        }
+        if (tagged) {
+            printf(" %12s |", allocation_names[job->config.allocation]);
+        }
+        printf("\n");
     }
+
+    free(jobs);
+    trace_close(&input_trace);
+    return status == 0 ? 0 : 1;
 }
 
-int main() {
+// 다른 프로그램에 시뮬레이터를 라이브러리로 포함할 때는 SIMULATOR_NO_MAIN을 정의하여 main을 제외
+// (예: #define SIMULATOR_NO_MAIN 후 #include "assignment4.c", sim_init/sim_step/sim_run/sim_free 사용)
+#ifndef SIMULATOR_NO_MAIN
+int main(int argc, char* argv[]) {
+    // 트레이스 형식 변환 모드
+    if (argc >= 2 && strcmp(argv[1], "convert") == 0) {
+        return convert_trace(argc - 2, argv + 2);
+    }
+
+    // 명령행 인자가 있으면 비대화형으로 실행
+    if (argc >= 2) {
+        return run_command_line(argc, argv);
+    }
+
     int virtual_address_length; // 가상주소의 길이
     int algorithm_choice;       // 페이지 교체 알고리즘 선택
     int input_choice;           // 가상주소 스트링 입력 방식 선택
     char input_filename[100];   // 입력 파일 이름
-
+    SimulationConfig config;
     // 가상주소의 길이 선택
     while (1) {
-        printf("A. Simulation에 사용할 가상주소 길이를 선택하시오 (1. 18bits     2. 19bits     3. 20bits): ");
+        printf("A. Simulation에 사용할 가상주소 길이를 선택하시오 (1. 18bits     2. 19bits     3. 20bits     4. 32bits     5. 48bits): ");
         scanf("%d", &virtual_address_length);
 
         if (virtual_address_length == 1) {
@@ -267,24 +4413,21 @@ int main() {
             virtual_address_length = 20;
             break;
         }
+        else if (virtual_address_length == 4) {
+            virtual_address_length = 32;
+            break;
+        }
+        else if (virtual_address_length == 5) {
+            virtual_address_length = 48;
+            break;
+        }
         else {
-            printf("잘못된 입력입니다. 1, 2, 3 중 하나를 입력해야 합니다.\n");
+            printf("잘못된 입력입니다. 1에서 5 사이의 값을 입력해야 합니다.\n");
         }
     }
 
-    // 가상 메모리 크기 계산 및 설정
-    unsigned long max_virtual_address;
-    if (virtual_address_length == 18) {
-        max_virtual_address = 256 * 1024; // 256KB
-    }
-    else if (virtual_address_length == 19) {
-        max_virtual_address = 512 * 1024; // 512KB
-    }
-    else if (virtual_address_length == 20) {
-        max_virtual_address = 1024 * 1024; // 1MB
-    }
-
     // 페이지 크기 선택 및 설정
+    int page_size;
     printf("B. Simulation에 사용할 페이지(프레임)의 크기를 선택하시오 (1. 1KB    2. 2KB     3. 4KB): ");
     scanf("%d", &page_size);
     if (page_size == 1) {
@@ -302,8 +4445,9 @@ int main() {
     }
 
     // 물리 메모리 크기 선택
+    long physical_memory_size;
     printf("C. Simulation에 사용할 물리 메모리의 크기를 선택하시오 (1. 32KB     2. 64KB): ");
-    scanf("%d", &physical_memory_size);
+    scanf("%ld", &physical_memory_size);
     if (physical_memory_size == 1) {
         physical_memory_size = 32 * 1024; // 32KB
     }
@@ -316,140 +4460,169 @@ int main() {
     }
 
     // 페이지 교체 알고리즘 선택
-    printf("D. Simulation에 적용할 Page Replacement 알고리즘을 선택하시오 (1. Optimal     2. FIFO     3. LRU    4. Second-Chance): ");
+    printf("D. Simulation에 적용할 Page Replacement 알고리즘을 선택하시오 (1. Optimal     2. FIFO     3. LRU    4. Second-Chance    5. Miss Ratio Curve(LRU/OPT 전체 프레임 수)"
+        "    6. ARC    7. 2Q    8. CLOCK-Pro    9. LFU    10. Working Set 분석(τ = 100, 1000, 10000)    11. Enhanced Second-Chance): ");
     scanf("%d", &algorithm_choice);
-    if (algorithm_choice < 1 || algorithm_choice > 4) {
-        printf("잘못된 입력입니다. 페이지 교체 알고리즘은 1에서 4 사이의 값을 입력해야 합니다.\n");
+    if (algorithm_choice < 1 || algorithm_choice > 11) {
+        printf("잘못된 입력입니다. 페이지 교체 알고리즘은 1에서 11 사이의 값을 입력해야 합니다.\n");
         return 0;
     }
-    Algorithm selected_algorithm = (Algorithm)(algorithm_choice - 1); // enum으로 변환
+    // 메뉴 번호 → enum (5번 Miss Ratio Curve와 10번 Working Set 분석은 알고리즘이 아닌 분석 모드)
+    static const Algorithm menu_algorithms[] = { OPTIMAL, FIFO, LRU, SECOND_CHANCE, OPTIMAL, ARC, TWO_QUEUE, CLOCK_PRO, LFU, FIFO, ENHANCED_SECOND_CHANCE };
+    int miss_ratio_curve_mode = (algorithm_choice == 5); // 모든 프레임 수에 대한 폴트 수를 한 번에 계산
+    int working_set_mode = (algorithm_choice == 10);     // 창 크기별 Working Set 크기와 폴트 비율 계산
+    Algorithm selected_algorithm = menu_algorithms[algorithm_choice - 1];
 
     // 가상주소 스트링 입력 방식 선택
-    printf("E. 가상주소 스트링 입력방식을 선택하시오 (1. input.in 자동 생성 2. 기존 파일 사용): ");
+    printf("E. 가상주소 스트링 입력방식을 선택하시오 (1. input.in 자동 생성 2. 기존 파일 사용 3. 합성 트레이스 생성(모델 지정)): ");
     scanf("%d", &input_choice);
-    if (input_choice != 1 && input_choice != 2) {
-        printf("잘못된 입력입니다. 가상주소 스트링 입력 방식은 1 또는 2 중에서 선택해야 합니다.\n");
+    if (input_choice < 1 || input_choice > 3) {
+        printf("잘못된 입력입니다. 가상주소 스트링 입력 방식은 1에서 3 중에서 선택해야 합니다.\n");
         return 0;
     }
     // 가상주소 입력 파일 생성 또는 기존 파일 사용
-    FILE* input_file;
+    TraceReader input_trace;
+    TraceGenerator generator;
 
     if (input_choice == 1) {
         // input.in 파일 자동 생성
-        input_file = fopen("input.in", "w");
+        FILE* input_file = fopen("input.in", "w");
         srand(time(NULL)); // 난수 생성 초기화
-        int max_virtual_address = (1 << virtual_address_length) - 1;
-        for (int i = 0; i < 5000; i++) {
-            int virtual_address = rand() % max_virtual_address;
-            fprintf(input_file, "%d\n", virtual_address);
+        unsigned long max_virtual_address = (1UL << virtual_address_length) - 1;
+        for (int i = 0; i < GENERATED_ACCESS_COUNT; i++) {
+            unsigned long random_value = (unsigned long)rand();
+            if (virtual_address_length > 30) {
+                random_value = (random_value << 31) | (unsigned long)rand(); // rand()는 31bits까지만 보장
+            }
+            unsigned long virtual_address = random_value % max_virtual_address;
+            fprintf(input_file, "%lu\n", virtual_address);
         }
         fclose(input_file);
-        input_file = fopen("input.in", "r"); // input.in 파일을 읽기 모드로 다시 열기
+        if (trace_open(&input_trace, "input.in") == -1) { // input.in 파일을 읽기 위해 다시 열기
+            printf("입력 파일을 열 수 없습니다.\n");
+            return 1;
+        }
     }
     else if (input_choice == 2) {
         // 기존 파일 사용
         printf("F. 입력 파일 이름을 입력하시오: ");
-        scanf("%s", input_filename);
-        input_file = fopen(input_filename, "r");
-        if (input_file == NULL) {
+        scanf("%99s", input_filename);
+        if (trace_open(&input_trace, input_filename) == -1) {
             printf("입력 파일을 열 수 없습니다. 파일 이름을 확인해주세요.\n");
             return 1;
         }
+
+        // 바이너리 트레이스는 기록된 페이지 크기보다 작은 페이지로는 시뮬레이션할 수 없음
+        if (input_trace.binary && (1UL << input_trace.page_shift) > (unsigned long)page_size) {
+            printf("바이너리 트레이스의 페이지 크기(%lu)가 선택한 페이지 크기보다 큽니다.\n", 1UL << input_trace.page_shift);
+            trace_close(&input_trace);
+            return 1;
+        }
+    }
+    else if (input_choice == 3) {
+        // 파일 없이 생성기에서 바로 시뮬레이터로 공급
+        char generator_spec[256];
+        unsigned long generate_count;
+        unsigned long seed;
+        int page_shift = 0;
+        while ((1 << page_shift) < page_size) {
+            page_shift++;
+        }
+
+        printf("F. 생성 모델을 입력하시오 (예: zipf:alpha=0.9,pages=64@0.7+scan:stride=1@0.3): ");
+        scanf("%255s", generator_spec);
+        printf("   생성할 가상주소 개수를 입력하시오: ");
+        scanf("%lu", &generate_count);
+        printf("   시드를 입력하시오: ");
+        scanf("%lu", &seed);
+        if (generate_count == 0 || trace_generator_init(&generator, generator_spec, seed, generate_count, page_shift, virtual_address_length) == -1) {
+            printf("잘못된 입력입니다. 생성 모델 명세를 확인해주세요.\n");
+            return 0;
+        }
+        trace_open_generator(&input_trace, &generator);
     }
     else {
-        printf("잘못된 입력입니다. 1 또는 2를 입력해야 합니다.\n");
+        printf("잘못된 입력입니다. 1, 2, 3 중 하나를 입력해야 합니다.\n");
         return 0;
     }
 
-    // 프레임 개수 계산
-    num_frames = physical_memory_size / page_size;
-
-    // 페이지 테이블 및 물리 메모리 초기화
-    int total_pages = max_virtual_address / page_size; // 전체 페이지 수 계산
-    page_table = malloc(total_pages * sizeof(PageTableEntry));
-    physical_memory = malloc(physical_memory_size * sizeof(int));
-
-
-    for (int i = 0; i < total_pages; i++) {
-        page_table[i].valid = 0;
-        page_table[i].frame = -1;
-        page_table[i].reference_bit = 0;
+    // PID가 기록된 트레이스는 프로세스별로 시뮬레이션하므로 프레임 할당 방식 선택
+    int allocation_choice = 0;
+    if (input_trace.tagged) {
+        if (selected_algorithm == OPTIMAL || miss_ratio_curve_mode || working_set_mode) {
+            printf("PID가 기록된 트레이스는 Optimal, Miss Ratio Curve, Working Set 분석을 지원하지 않습니다.\n");
+            trace_close(&input_trace);
+            return 0;
+        }
+        printf("   프레임 할당 방식을 선택하시오 (1. 균등 분할     2. 비례 분할     3. 전역 풀(PFF, FIFO/LRU/Second-Chance 계열)): ");
+        scanf("%d", &allocation_choice);
+        if (allocation_choice < 1 || allocation_choice > 3 || (allocation_choice == 3 && !sim_supports_frame_limit(selected_algorithm))) {
+            printf("잘못된 입력입니다. 프레임 할당 방식을 확인해주세요.\n");
+            trace_close(&input_trace);
+            return 0;
+        }
     }
-    for (int i = 0; i < physical_memory_size; i++) {
-        physical_memory[i] = -1; // 물리 메모리를 초기값(-1)으로 설정
+
+    // 결과 출력 방식 선택 (Miss Ratio Curve, Working Set 분석은 항상 표 형식)
+    OutputMode output_mode = OUTPUT_TABLE;
+    if (!miss_ratio_curve_mode && !working_set_mode) {
+        int output_choice;
+        printf("G. 결과 출력 방식을 선택하시오 (1. 표     2. 바이너리 레코드     3. 요약(폴트 총계 및 히트율 히스토그램)): ");
+        scanf("%d", &output_choice);
+        if (output_choice < 1 || output_choice > 3) {
+            printf("잘못된 입력입니다. 결과 출력 방식은 1에서 3 사이의 값을 입력해야 합니다.\n");
+            trace_close(&input_trace);
+            return 0;
+        }
+        output_mode = (OutputMode)(output_choice - 1);
     }
 
-    FILE* output_file;
-    char output_filename[100];
+    memset(&config, 0, sizeof(config)); // 대화형 모드에서는 TLB 모델을 사용하지 않음
+    config.address_bits = virtual_address_length;
+    config.page_size = page_size;
+    config.physical_memory_size = physical_memory_size;
+    config.algorithm = selected_algorithm;
+    config.miss_ratio_curve = miss_ratio_curve_mode;
+    config.working_set = working_set_mode;
+    config.ws_windows[0] = 100;
+    config.ws_windows[1] = 1000;
+    config.ws_windows[2] = 10000;
+    config.ws_window_count = 3;
+    config.ws_interval = WS_DEFAULT_INTERVAL;
+    config.multi_process = input_trace.tagged;
+    config.allocation = (FrameAllocation)(allocation_choice > 0 ? allocation_choice - 1 : 0);
+    config.pff.lower = PFF_DEFAULT_LOWER;
+    config.pff.upper = PFF_DEFAULT_UPPER;
+    config.pff.window = PFF_DEFAULT_WINDOW;
+    config.io.enabled = input_trace.rw; // 읽기/쓰기 구분이 있는 트레이스는 기본 I/O 비용으로 쓰기 저장 수와 I/O 시간을 기록
+    config.io.read_us = IO_DEFAULT_READ_US;
+    config.io.write_us = IO_DEFAULT_WRITE_US;
+    config.output_mode = output_mode;
 
     // 페이지 교체 알고리즘에 따라 출력 파일 이름 설정
-    switch (selected_algorithm) {
-    case OPTIMAL:
-        sprintf(output_filename, "output.opt");
-        break;
-    case FIFO:
-        sprintf(output_filename, "output.fifo");
-        break;
-    case LRU:
-        sprintf(output_filename, "output.lru");
-        break;
-    case SECOND_CHANCE:
-        sprintf(output_filename, "output.sc");
-        break;
-    default:
-        fprintf(stderr, "알 수 없는 페이지 교체 알고리즘입니다.\n");
-        return 1;
+    char output_filename[100];
+    if (miss_ratio_curve_mode) {
+        sprintf(output_filename, "output.mrc");
     }
-
-    // 출력 파일 열기
-    output_file = fopen(output_filename, "w");
-    if (output_file == NULL) {
-        fprintf(stderr, "출력 파일을 생성할 수 없습니다.\n");
-        return 1;
+    else if (working_set_mode) {
+        sprintf(output_filename, "output.ws");
     }
-
-    // 한글 헤더 추가
-    fprintf(output_file, "     NO.      V.A      Page No.   Frame No.      P.A.     Page Fault \n");
-
-    int virtual_address, page_faults = 0, current_frame = 0, current_time = 0;
-    char page_fault_occurred = 'F';
-
-    // 순서 추적을 위한 카운터
-    int count = 0;
-    int page_fault_count = 0;
-
-    // 가상 주소 처리 루프
-    int future_accesses[MAX_FUTURE_ACCESSES];
-    int future_index = 0;
-
-    // 미래 액세스 정보를 future_accesses 배열에 저장
-    while (fscanf(input_file, "%d", &future_accesses[future_index]) != EOF && future_index < MAX_FUTURE_ACCESSES) {
-        future_index++;
+    else {
+        sprintf(output_filename, "output.%s", algorithm_names[selected_algorithm]);
     }
 
-    rewind(input_file);  // 입력 파일 포인터를 다시 시작 부분으로 이동
-
-    future_index = 0; // 현재 처리 중인 가상 주소 인덱스 초기화
-
-    while (fscanf(input_file, "%d", &virtual_address) != EOF) {
-        page_faults = handle_virtual_address(virtual_address, &page_faults, &current_frame, selected_algorithm, &page_fault_occurred, future_index, future_accesses, &current_time);
-
-        if (page_fault_occurred == 'F') {
-            page_fault_count++;
-        }
-
-        // 결과 기록
-        record_page_replacement_result(output_file, virtual_address, page_faults, page_fault_occurred, ++count, page_fault_count);
-
-        future_index++; // 현재 처리 중인 가상 주소 인덱스 증가
+    // 바이너리 레코드는 같은 이름에 .bin을 붙여 구분
+    if (output_mode == OUTPUT_BINARY) {
+        strcat(output_filename, ".bin");
     }
+    config.output_filename = output_filename;
 
-    // 파일 및 메모리 자원 정리
-    fclose(input_file);
-    fclose(output_file);
-    if (page_table) free(page_table);
-    if (physical_memory) free(physical_memory);
+    SimulationResult result;
+    int status = run_simulations(&config, 1, &input_trace, NULL, NULL, NULL, 0, &result);
 
-    return 0;
-}
+    // 파일 자원 정리
+    trace_close(&input_trace);
 
+    return status == 0 ? 0 : 1;
+}
+#endif
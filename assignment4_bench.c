@@ -0,0 +1,387 @@
+// assignment4.c 페이지 교체 엔진의 마이크로벤치마크 및 성능 회귀 검사
+// 빌드: gcc -O2 -o assignment4_bench assignment4_bench.c -lm -pthread
+//
+// 알고리즘 × 프레임 수 × 트레이스 길이 × 지역성 모델의 모든 조합에 대해 sim_step의 액세스당 비용과 폴트 수를 측정
+// 한 스텝은 시계 호출 비용보다 짧으므로 BENCH_BLOCK 스텝 묶음의 시간을 재고, 묶음별 스텝당 비용으로 p50/p99를 계산
+// 각 조합을 여러 번 실행하여 전체 시간이 가장 짧은 실행을 결과로 사용 (다른 프로세스의 간섭 제거)
+//
+// -s로 결과를 기준 파일에 저장하고, -c로 기준 파일과 비교하여 ns/access가 허용 오차보다 느려졌거나
+// 폴트 수가 달라진(동작이 바뀐) 조합이 있으면 0이 아닌 값으로 종료
+#define SIMULATOR_NO_MAIN
+#include "assignment4.c"
+
+#define BENCH_BLOCK 256             // 시간을 재는 스텝 묶음의 크기
+#define BENCH_MAX_FRAMES 16
+#define BENCH_MAX_LENGTHS 8
+#define BENCH_MAX_RESULTS 4096
+#define BENCH_DEFAULT_TOLERANCE 0.10
+
+// 지역성 모델 (페이지 수는 프레임 수의 2배로 하여 항상 교체가 일어나도록 함)
+typedef struct {
+    const char* name;
+    const char* spec;   // 합성 트레이스 명세 (%lu: 페이지 수, 프레임 수 순서로 치환)
+} BenchModel;
+
+static const BenchModel bench_models[] = {
+    { "uniform", "uniform:pages=%lu" },
+    { "zipf", "zipf:alpha=0.9,pages=%lu" },
+    { "phase", "phase:pages=%lu,set=%lu,length=10000" },                   // 작업 집합이 메모리에 들어감
+    { "scan", "zipf:alpha=0.9,pages=%lu@0.8+scan:start=%lu,pages=1M@0.2" }, // 핫셋 + 한 번만 읽는 스캔
+};
+#define BENCH_MODEL_COUNT (int)(sizeof(bench_models) / sizeof(bench_models[0]))
+
+// 조합 하나의 측정 결과
+typedef struct {
+    char model[16];
+    char algorithm[16];
+    unsigned long frames;
+    unsigned long length;
+    double ns_per_access;
+    double p50;         // 스텝당 비용의 중앙값 (ns)
+    double p99;
+    long page_faults;
+} BenchResult;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// 모델과 프레임 수에 맞는 트레이스를 생성하는 함수 (실패 시 NULL)
+static unsigned long* bench_generate(const BenchModel* model, unsigned long frames, unsigned long length, int page_shift) {
+    char spec[256];
+    unsigned long pages = 2 * frames;
+    unsigned long second = strstr(model->spec, "set=") != NULL ? (frames * 3 / 4 > 0 ? frames * 3 / 4 : 1) : pages;
+    TraceGenerator gen;
+
+    snprintf(spec, sizeof(spec), model->spec, pages, second);
+    if (trace_generator_init(&gen, spec, 1, length, page_shift, 48) == -1) {
+        return NULL;
+    }
+    unsigned long* trace = malloc(length * sizeof(unsigned long));
+    for (unsigned long i = 0; i < length; i++) {
+        trace_generator_next(&gen, &trace[i]);
+    }
+    return trace;
+}
+
+// 트레이스 하나를 한 번 실행하여 전체 시간과 묶음별 스텝당 비용을 기록하는 함수 (폴트 수 반환, 설정이 잘못되었으면 -1)
+static long bench_run_once(Algorithm algorithm, unsigned long frames, const unsigned long* trace, int length,
+    const int* next_use, double* total_ns, double* samples) {
+    Simulator sim;
+    if (sim_init(&sim, algorithm, 48, 4096, (long)frames * 4096) == -1) {
+        return -1;
+    }
+    sim_set_next_use(&sim, next_use);
+
+    double start = now_ns();
+    double block_start = start;
+    int sample_count = 0;
+    for (int i = 0; i < length; i += BENCH_BLOCK) {
+        int count = length - i < BENCH_BLOCK ? length - i : BENCH_BLOCK;
+        sim_run(&sim, trace + i, NULL, count);
+        double block_end = now_ns();
+        samples[sample_count++] = (block_end - block_start) / count;
+        block_start = block_end;
+    }
+    *total_ns = block_start - start;
+
+    long page_faults = sim.page_faults;
+    sim_free(&sim);
+    return page_faults;
+}
+
+// 조합 하나를 repeat번 실행하고 가장 빠른 실행을 결과로 기록하는 함수 (성공 시 0)
+static int bench_case(BenchResult* result, Algorithm algorithm, unsigned long frames, const unsigned long* trace, int length,
+    const int* next_use, int repeat) {
+    int sample_count = (length + BENCH_BLOCK - 1) / BENCH_BLOCK;
+    double* samples = malloc(sample_count * sizeof(double));
+    double* best_samples = malloc(sample_count * sizeof(double));
+    double best = -1;
+
+    for (int r = 0; r < repeat; r++) {
+        double total;
+        long page_faults = bench_run_once(algorithm, frames, trace, length, next_use, &total, samples);
+        if (page_faults == -1) {
+            free(samples);
+            free(best_samples);
+            return -1;
+        }
+        if (best < 0 || total < best) {
+            best = total;
+            memcpy(best_samples, samples, sample_count * sizeof(double));
+        }
+        result->page_faults = page_faults;
+    }
+
+    qsort(best_samples, sample_count, sizeof(double), compare_double);
+    result->ns_per_access = best / length;
+    result->p50 = best_samples[sample_count / 2];
+    result->p99 = best_samples[(int)(sample_count * 0.99) < sample_count ? (int)(sample_count * 0.99) : sample_count - 1];
+    free(samples);
+    free(best_samples);
+    return 0;
+}
+
+// 기준 파일을 읽는 함수 (읽은 결과 수 반환, 파일을 열 수 없으면 -1)
+// 형식: 한 줄에 "모델 알고리즘 프레임 수 길이 ns/access p50 p99 폴트 수", #으로 시작하는 줄은 주석
+static int bench_load_baseline(const char* filename, BenchResult* results, int max_results) {
+    FILE* file = fopen(filename, "r");
+    char line[256];
+    int count = 0;
+
+    if (file == NULL) {
+        return -1;
+    }
+    while (count < max_results && fgets(line, sizeof(line), file) != NULL) {
+        BenchResult* result = &results[count];
+        if (line[0] == '#') {
+            continue;
+        }
+        if (sscanf(line, "%15s %15s %lu %lu %lf %lf %lf %ld", result->model, result->algorithm, &result->frames, &result->length,
+                &result->ns_per_access, &result->p50, &result->p99, &result->page_faults) == 8) {
+            count++;
+        }
+    }
+    fclose(file);
+    return count;
+}
+
+static int bench_save_baseline(const char* filename, const BenchResult* results, int count) {
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        return -1;
+    }
+    fprintf(file, "# model algorithm frames length ns/access p50 p99 faults\n");
+    for (int i = 0; i < count; i++) {
+        fprintf(file, "%s %s %lu %lu %.3f %.3f %.3f %ld\n", results[i].model, results[i].algorithm, results[i].frames, results[i].length,
+            results[i].ns_per_access, results[i].p50, results[i].p99, results[i].page_faults);
+    }
+    fclose(file);
+    return 0;
+}
+
+static const BenchResult* bench_find(const BenchResult* results, int count, const BenchResult* key) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(results[i].model, key->model) == 0 && strcmp(results[i].algorithm, key->algorithm) == 0
+            && results[i].frames == key->frames && results[i].length == key->length) {
+            return &results[i];
+        }
+    }
+    return NULL;
+}
+
+static void bench_usage(const char* program) {
+    fprintf(stderr,
+        "사용법: %s [옵션]\n"
+        "  -a, --algorithm 목록     측정할 알고리즘 (기본: opt,fifo,lru,sc,esc,arc,2q,clockpro,lfu)\n"
+        "  -f, --frames 목록        프레임 수 (기본: 16,256,4K,64K,1M)\n"
+        "  -n, --length 목록        트레이스 길이 (기본: 100000,1000000)\n"
+        "  -l, --locality 목록      지역성 모델: uniform, zipf, phase, scan (기본: 전부)\n"
+        "  -r, --repeat 횟수        조합마다 반복 실행 횟수 (기본: 3, 가장 빠른 실행을 사용)\n"
+        "  -s, --save 파일          결과를 기준 파일로 저장\n"
+        "  -c, --compare 파일       기준 파일과 비교하여 느려졌거나 폴트 수가 달라지면 실패\n"
+        "  -x, --tolerance 비율     ns/access 허용 오차 (기본: %.2f)\n",
+        program, BENCH_DEFAULT_TOLERANCE);
+}
+
+int main(int argc, char* argv[]) {
+    static const struct option options[] = {
+        { "algorithm", required_argument, NULL, 'a' },
+        { "frames", required_argument, NULL, 'f' },
+        { "length", required_argument, NULL, 'n' },
+        { "locality", required_argument, NULL, 'l' },
+        { "repeat", required_argument, NULL, 'r' },
+        { "save", required_argument, NULL, 's' },
+        { "compare", required_argument, NULL, 'c' },
+        { "tolerance", required_argument, NULL, 'x' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    unsigned long algorithms[ALGORITHM_COUNT + 2];
+    unsigned long frames[BENCH_MAX_FRAMES] = { 16, 256, 4096, 65536, 1048576 };
+    unsigned long lengths[BENCH_MAX_LENGTHS] = { 100000, 1000000 };
+    int models[BENCH_MODEL_COUNT];
+    int algorithm_count = ALGORITHM_COUNT, frame_count = 5, length_count = 2, model_count = BENCH_MODEL_COUNT;
+    int repeat = 3;
+    double tolerance = BENCH_DEFAULT_TOLERANCE;
+    const char* save_filename = NULL;
+    const char* compare_filename = NULL;
+    int option;
+
+    for (int i = 0; i < ALGORITHM_COUNT; i++) {
+        algorithms[i] = i;
+    }
+    for (int i = 0; i < BENCH_MODEL_COUNT; i++) {
+        models[i] = i;
+    }
+
+    while ((option = getopt_long(argc, argv, "a:f:n:l:r:s:c:x:h", options, NULL)) != -1) {
+        int parsed = 1;
+        switch (option) {
+        case 'a':
+            parsed = algorithm_count = parse_list(optarg, algorithms, ALGORITHM_COUNT + 2, 1);
+            for (int i = 0; i < algorithm_count; i++) {
+                if (algorithms[i] >= ALGORITHM_COUNT) {
+                    parsed = -1; // mrc, ws는 분석 모드이므로 측정 대상이 아님
+                }
+            }
+            break;
+        case 'f':
+            parsed = frame_count = parse_list(optarg, frames, BENCH_MAX_FRAMES, 0);
+            for (int i = 0; i < frame_count; i++) {
+                if (frames[i] == 0 || frames[i] > MAX_FRAMES) {
+                    parsed = -1;
+                }
+            }
+            break;
+        case 'n':
+            parsed = length_count = parse_list(optarg, lengths, BENCH_MAX_LENGTHS, 0);
+            for (int i = 0; i < length_count; i++) {
+                if (lengths[i] == 0 || lengths[i] > INT_MAX) {
+                    parsed = -1;
+                }
+            }
+            break;
+        case 'l': {
+            char buffer[256];
+            model_count = 0;
+            snprintf(buffer, sizeof(buffer), "%s", optarg);
+            for (char* item = strtok(buffer, ","); item != NULL && parsed == 1; item = strtok(NULL, ",")) {
+                parsed = -1;
+                for (int i = 0; i < BENCH_MODEL_COUNT && model_count < BENCH_MODEL_COUNT; i++) {
+                    if (strcmp(item, bench_models[i].name) == 0) {
+                        models[model_count++] = i;
+                        parsed = 1;
+                    }
+                }
+            }
+            break;
+        }
+        case 'r':
+            repeat = (int)strtol(optarg, NULL, 10);
+            parsed = repeat > 0 ? 1 : -1;
+            break;
+        case 's':
+            save_filename = optarg;
+            break;
+        case 'c':
+            compare_filename = optarg;
+            break;
+        case 'x':
+            tolerance = strtod(optarg, NULL);
+            parsed = tolerance >= 0 ? 1 : -1;
+            break;
+        default:
+            bench_usage(argv[0]);
+            return option == 'h' ? 0 : 1;
+        }
+        if (parsed <= 0) {
+            fprintf(stderr, "잘못된 옵션 값입니다: -%c %s\n", option, optarg);
+            return 1;
+        }
+    }
+    if (optind != argc) {
+        bench_usage(argv[0]);
+        return 1;
+    }
+
+    BenchResult* baseline = NULL;
+    int baseline_count = 0;
+    if (compare_filename != NULL) {
+        baseline = calloc(BENCH_MAX_RESULTS, sizeof(BenchResult));
+        baseline_count = bench_load_baseline(compare_filename, baseline, BENCH_MAX_RESULTS);
+        if (baseline_count == -1) {
+            fprintf(stderr, "기준 파일을 열 수 없습니다: %s\n", compare_filename);
+            free(baseline);
+            return 1;
+        }
+    }
+
+    BenchResult* results = calloc(BENCH_MAX_RESULTS, sizeof(BenchResult));
+    int result_count = 0;
+    int regressions = 0;
+
+    printf("    Model  Algorithm      Frames      Length   ns/access     p50(ns)     p99(ns)   Page Faults%s\n",
+        baseline != NULL ? "    vs Base" : "");
+
+    for (int m = 0; m < model_count; m++) {
+        const BenchModel* model = &bench_models[models[m]];
+        for (int f = 0; f < frame_count; f++) {
+            for (int n = 0; n < length_count; n++) {
+                // 트레이스와 Optimal의 다음 사용 시점은 조합의 모든 알고리즘이 공유
+                unsigned long* trace = bench_generate(model, frames[f], lengths[n], 12);
+                int* next_use = NULL;
+                if (trace == NULL) {
+                    fprintf(stderr, "트레이스를 생성할 수 없습니다: %s, 프레임 %lu\n", model->name, frames[f]);
+                    continue;
+                }
+
+                for (int a = 0; a < algorithm_count && result_count < BENCH_MAX_RESULTS; a++) {
+                    BenchResult* result = &results[result_count];
+                    snprintf(result->model, sizeof(result->model), "%s", model->name);
+                    snprintf(result->algorithm, sizeof(result->algorithm), "%s", algorithm_names[algorithms[a]]);
+                    result->frames = frames[f];
+                    result->length = lengths[n];
+
+                    if (algorithms[a] == OPTIMAL && next_use == NULL) {
+                        next_use = build_next_use(trace, (int)lengths[n], 12);
+                    }
+                    if (bench_case(result, (Algorithm)algorithms[a], frames[f], trace, (int)lengths[n], next_use, repeat) == -1) {
+                        fprintf(stderr, "시뮬레이터를 초기화할 수 없습니다: %s, 프레임 %lu\n", result->algorithm, frames[f]);
+                        continue;
+                    }
+                    result_count++;
+
+                    printf("| %7s | %9s | %9lu | %9lu | %9.2f | %9.2f | %9.2f | %11ld |", result->model, result->algorithm,
+                        result->frames, result->length, result->ns_per_access, result->p50, result->p99, result->page_faults);
+
+                    // 기준과 비교 (폴트 수가 다르면 동작이 바뀐 것이므로 속도와 관계없이 실패)
+                    const BenchResult* base = baseline != NULL ? bench_find(baseline, baseline_count, result) : NULL;
+                    if (base != NULL) {
+                        double ratio = result->ns_per_access / base->ns_per_access;
+                        const char* verdict = "";
+                        if (result->page_faults != base->page_faults) {
+                            verdict = " FAULTS CHANGED";
+                            regressions++;
+                        }
+                        else if (ratio > 1 + tolerance) {
+                            verdict = " REGRESSION";
+                            regressions++;
+                        }
+                        printf(" %8.3fx |%s", ratio, verdict);
+                    }
+                    else if (baseline != NULL) {
+                        printf(" %9s |", "new");
+                    }
+                    printf("\n");
+                    fflush(stdout);
+                }
+                free(trace);
+                free(next_use);
+            }
+        }
+    }
+
+    int status = 0;
+    if (save_filename != NULL && bench_save_baseline(save_filename, results, result_count) == -1) {
+        fprintf(stderr, "기준 파일을 저장할 수 없습니다: %s\n", save_filename);
+        status = 1;
+    }
+    if (baseline != NULL) {
+        printf("%d개 조합 중 %d개가 기준보다 느려졌거나 폴트 수가 달라졌습니다. (허용 오차 %.0f%%)\n", result_count, regressions, tolerance * 100);
+        if (regressions > 0) {
+            status = 1;
+        }
+    }
+
+    free(results);
+    free(baseline);
+    return status;
+}
@@ -1,3 +1,4 @@
+#define _GNU_SOURCE // RUSAGE_THREAD
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
@@ -9,20 +10,255 @@
 #include <sched.h>
 #include <time.h>
 #include <errno.h> // For error handling
+#include <stdint.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <signal.h>
+#include <math.h>
+#include <sys/utsname.h>
+#include <linux/mempolicy.h>
+#include <stdatomic.h>
+#include <linux/perf_event.h>
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
 
-#define NUM_PROCESSES 21
+#define NUM_PROCESSES 21 // default worker count
+#define MAX_WORKERS 4096
+#define MAX_NICE_GROUPS 40
 #define MATRIX_SIZE 100
 
+#define CACHE_LINE_SIZE 64
+#define GEMM_BLOCK 64
+#define INTERACTIVE_SLEEP_RATIO 4 // sleep 4x as long as each CPU burst (20% duty cycle)
+
+typedef enum {
+    WORKLOAD_MATRIX = 1,
+    WORKLOAD_GEMM,
+    WORKLOAD_STREAM,
+    WORKLOAD_CHASE,
+    WORKLOAD_INTERACTIVE
+} WorkloadKind;
+
+typedef struct {
+    WorkloadKind kind;
+    long size;    // GEMM: matrix order, STREAM/CHASE: footprint in KB, INTERACTIVE: burst in usec
+    int repeat;   // passes over the kernel
+} Workload;
+
+static const char *workload_names[] = { "", "MATRIX", "GEMM_BLOCKED", "STREAM", "POINTER_CHASE", "INTERACTIVE" };
+static const char *workload_units[] = { "", "", "order", "KB", "KB", "usec burst" };
+static const Workload workload_defaults[] = {
+    { 0, 0, 0 },
+    { WORKLOAD_MATRIX, MATRIX_SIZE, 100 },
+    { WORKLOAD_GEMM, 256, 4 },
+    { WORKLOAD_STREAM, 64 * 1024, 10 },
+    { WORKLOAD_CHASE, 32 * 1024, 2 },
+    { WORKLOAD_INTERACTIVE, 1000, 50 }
+};
+
+// Kernel results are stored here so the compiler cannot drop the work
+volatile double workload_sink;
+
+typedef enum {
+    POLICY_CFS_DEFAULT = 1,
+    POLICY_CFS_NICE,
+    POLICY_RT_FIFO,
+    POLICY_RT_RR,
+    POLICY_BATCH,
+    POLICY_IDLE,
+    POLICY_DEADLINE,
+    POLICY_MIXED // per-group policies from a --mix spec
+} Policy;
+
+#define POLICY_COUNT 7 // policies selectable with -p
+#define MAX_CLASSES 16
+#define DEADLINE_DEFAULT_RUNTIME_US 10000
+#define DEADLINE_DEFAULT_PERIOD_US 100000
+#define MAX_LATENCY_THREADS 64
+#define LATENCY_DEFAULT_INTERVAL_US 1000
+#define LATENCY_HISTOGRAM_US 10000 // 1 usec buckets, longer wakeups only count as overflow
+#define LATENCY_LOG_BUCKETS 15     // summary histogram rows: <=1, <=2, <=4 ... <=8192 usec, then longer
+
+static const char *policy_names[] = { "", "CFS_DEFAULT", "CFS_NICE", "RT_FIFO", "RT_RR", "BATCH", "IDLE", "DEADLINE", "MIXED" };
+static const char *policy_options[] = { "", "cfs", "nice", "fifo", "rr", "batch", "idle", "deadline" };
+static const char *workload_options[] = { "", "matrix", "gemm", "stream", "chase", "interactive" };
+
+typedef enum {
+    MODE_PROCESS,
+    MODE_THREAD
+} ExecMode;
+
+typedef enum {
+    EXPORT_NONE,
+    EXPORT_CSV,
+    EXPORT_JSON
+} ExportFormat;
+
+typedef enum {
+    PLACEMENT_FREE,   // no affinity, the kernel places workers anywhere in the inherited cpuset
+    PLACEMENT_SINGLE, // every worker pinned to one CPU
+    PLACEMENT_CORES,  // every worker restricted to the same set of N CPUs
+    PLACEMENT_NUMA    // worker i bound to the CPUs and memory of node i % nodes
+} Placement;
+
+static const char *placement_names[] = { "free", "single", "cores", "numa" };
+
+typedef struct {
+    int nice_value;
+    int count; // 0 = an even share of the workers not claimed by other groups
+} NiceGroup;
+
+// How one worker is scheduled. A uniform run derives it from the policy; a mixed run
+// takes it from the --mix group the worker falls in.
 typedef struct {
-    int pid;
+    Policy policy;
+    int count;           // workers in this --mix group
+    int nice_value;      // CFS and BATCH
+    int rt_priority;     // RT_FIFO and RT_RR
+    unsigned long long runtime_ns; // DEADLINE
+    unsigned long long deadline_ns;
+    unsigned long long period_ns;
+} TaskClass;
+
+// Layout of the kernel's struct sched_attr (SCHED_ATTR_SIZE_VER0), which older glibc lacks
+typedef struct {
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+} SchedAttr;
+
+// Mapped MAP_SHARED so forked workers can open and close the timer threads' sampling window:
+// open from the first worker past the start barrier until every worker has finished
+typedef struct {
+    atomic_int released;
+    atomic_int finished;
+} LatencyWindow;
+
+typedef struct {
+    Policy policy; // the policy being run
+    Policy policies[POLICY_COUNT]; // every policy to compare, each run for warmup + trials rounds
+    int policy_count;
+    int trials;
+    int warmup; // leading trials per policy that are run but left out of the statistics
+    ExportFormat export_format;
+    const char *export_path;
+    int time_quantum; // RT_RR time slice in ms, 0 leaves the system setting alone
+    int num_workers;
+    ExecMode mode;
+    Workload workload;
+    NiceGroup nice_groups[MAX_NICE_GROUPS]; // used by CFS_NICE, workers are assigned in group order
+    int nice_group_count;
+    Placement placement;
+    int placement_arg;       // PLACEMENT_SINGLE: CPU (-1 = first allowed), PLACEMENT_CORES: CPU count
+    cpu_set_t *worker_cpus;  // per-worker affinity built by plan_placement, NULL for PLACEMENT_FREE
+    int *worker_nodes;       // PLACEMENT_NUMA: preferred memory node of each worker
+    TaskClass deadline;      // DEADLINE parameters of a uniform run
+    TaskClass classes[MAX_CLASSES]; // POLICY_MIXED groups, workers are assigned in group order
+    int class_count;
+    int latency_threads;     // cyclictest-style timer threads run under the policy, 0 = off
+    long latency_interval_us;
+    const char *histogram_path;
+    LatencyWindow *latency_window; // NULL without --latency
+} BenchConfig;
+
+// Wakeup latency (actual minus programmed wakeup time) of timer threads
+typedef struct {
+    long long samples;
+    long long sum_ns;
+    long long min_ns;
+    long long max_ns;
+    long long overflow;
+    long long buckets[LATENCY_HISTOGRAM_US];
+} LatencyHistogram;
+
+typedef struct {
+    const BenchConfig *config;
+    int worker; // the timer shares this worker's placement
+    TaskClass cls;
+    long long interval_ns;
+    atomic_int *stop;
+    int policy_errno;
+    pthread_t thread;
+    LatencyHistogram histogram;
+} TimerThread;
+
+typedef struct {
+    int pid; // thread id in thread mode
     int nice_value;
-    char start_time[100];
-    long start_usec;
-    char end_time[100];
-    long end_usec;
-    double elapsed_seconds;
+    Policy policy;          // scheduling class this worker asked for
+    int policy_errno;       // 0 when the class was applied, else why the kernel refused it
+    long long start_ns; // CLOCK_MONOTONIC, when the worker first ran after the start barrier
+    long long end_ns;
+    double elapsed_seconds; // from the barrier release (earliest start_ns of any worker) to end_ns
+    double user_seconds;
+    double system_seconds;
+    long voluntary_switches;
+    long involuntary_switches;
+    long long run_delay_ns; // time spent runnable but waiting for a CPU, -1 without schedstat
+    long long cycles;       // -1 when perf events are unavailable
+    long long instructions;
+    int start_cpu;          // CPU when the worker first ran after the barrier
+    int end_cpu;
+    long migrations;        // CPU migrations during the workload, -1 without /proc/<tid>/sched
+    int node;               // PLACEMENT_NUMA memory node, -1 otherwise
 } ProcessInfo;
 
+// Statistics over the measured trials of one policy. Percentiles and stddev pool the
+// elapsed time of every worker in every trial; the confidence interval is over trial means.
+typedef struct {
+    Policy policy;
+    char label[48]; // policy name, or MIXED/<group> for one group of a mixed run
+    int trials;
+    int samples;
+    double mean;
+    double stddev;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+    double ci_low; // 95% confidence interval of the mean, equal to mean with a single trial
+    double ci_high;
+    double fairness; // Jain's index of worker throughput (1 / elapsed), averaged over trials
+    double cpu_seconds; // per worker
+    double run_delay_seconds; // per worker, -1 without schedstat
+    int refused; // samples whose worker kept the default policy, so the row is not a result for this policy
+    LatencyHistogram *latency; // timer threads of every measured trial, NULL without --latency
+} PolicyStats;
+
+// One slot per worker, padded to whole cache lines so workers never write to a shared line
+typedef struct {
+    ProcessInfo info;
+    int valid; // set once the worker has filled in info
+} __attribute__((aligned(CACHE_LINE_SIZE))) ResultSlot;
+
+// Lives in a MAP_SHARED mapping so forked workers and threads use the same barrier and slots
+typedef struct {
+    pthread_barrier_t start_barrier;
+    ResultSlot slots[];
+} __attribute__((aligned(CACHE_LINE_SIZE))) SharedResults;
+
+// Snapshot of the per-task counters taken before and after the workload
+typedef struct {
+    long long time_ns;
+    struct rusage usage;
+    long long run_delay_ns;
+    long migrations;
+} TaskSample;
+
+typedef struct {
+    int leader_fd; // cycles, -1 when perf_event_open is not permitted
+    int instructions_fd;
+} PerfCounters;
+
 void perform_matrix_operation() {
     int A[MATRIX_SIZE][MATRIX_SIZE], B[MATRIX_SIZE][MATRIX_SIZE], result[MATRIX_SIZE][MATRIX_SIZE];
     int i, j, k, count = 0;
@@ -45,185 +281,1934 @@ void perform_matrix_operation() {
         }
         count++;
     }
+
+    workload_sink = result[MATRIX_SIZE - 1][MATRIX_SIZE - 1];
 }
 
-int compare_nice(const void *a, const void *b) {
-    return ((ProcessInfo *)a)->nice_value - ((ProcessInfo *)b)->nice_value;
+static void *alloc_aligned(size_t bytes) {
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, CACHE_LINE_SIZE, bytes) != 0) {
+        perror("Workload allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
 }
 
-double total_elapsed_seconds = 0.0;
+// C += A * B on n x n doubles, tiled so three GEMM_BLOCK x GEMM_BLOCK tiles stay in L1/L2.
+// The innermost loop runs over contiguous columns of B and C so it vectorizes.
+void perform_blocked_gemm(int n, int repeat) {
+    double *A = alloc_aligned((size_t)n * n * sizeof(double));
+    double *B = alloc_aligned((size_t)n * n * sizeof(double));
+    double *C = alloc_aligned((size_t)n * n * sizeof(double));
 
-int main() {
-    pid_t child_pids[NUM_PROCESSES];
-    int policy;
-    struct sched_param param;
-    double total_elapsed_time = 0;
-    int pipefd[2];
+    for(int i = 0; i < n * n; i++) {
+        A[i] = (double)(i % n);
+        B[i] = (double)(i / n);
+        C[i] = 0.0;
+    }
 
-    if (pipe(pipefd) == -1) {
-        perror("Pipe creation failed");
-        exit(EXIT_FAILURE);
+    for(int count = 0; count < repeat; count++) {
+        for(int ii = 0; ii < n; ii += GEMM_BLOCK) {
+            int i_end = ii + GEMM_BLOCK < n ? ii + GEMM_BLOCK : n;
+            for(int kk = 0; kk < n; kk += GEMM_BLOCK) {
+                int k_end = kk + GEMM_BLOCK < n ? kk + GEMM_BLOCK : n;
+                for(int jj = 0; jj < n; jj += GEMM_BLOCK) {
+                    int j_end = jj + GEMM_BLOCK < n ? jj + GEMM_BLOCK : n;
+                    for(int i = ii; i < i_end; i++) {
+                        double *restrict c_row = C + (size_t)i * n;
+                        for(int k = kk; k < k_end; k++) {
+                            const double a = A[(size_t)i * n + k];
+                            const double *restrict b_row = B + (size_t)k * n;
+                            int j = jj;
+#if defined(__AVX2__) && defined(__FMA__)
+                            __m256d va = _mm256_set1_pd(a);
+                            for(; j + 4 <= j_end; j += 4) {
+                                __m256d vc = _mm256_loadu_pd(c_row + j);
+                                vc = _mm256_fmadd_pd(va, _mm256_loadu_pd(b_row + j), vc);
+                                _mm256_storeu_pd(c_row + j, vc);
+                            }
+#endif
+                            for(; j < j_end; j++) {
+                                c_row[j] += a * b_row[j];
+                            }
+                        }
+                    }
+                }
+            }
+        }
     }
 
-    printf("Choose a scheduling policy:\n");
-    printf("1. CFS_DEFAULT\n2. CFS_NICE\n3. RT_FIFO\n4. RT_RR\n0. Exit\n");
-    scanf("%d", &policy);
+    workload_sink = C[(size_t)n * n - 1];
+    free(A);
+    free(B);
+    free(C);
+}
 
-    if (policy < 1 || policy > 4) {
-        printf("Exiting program.\n");
-        exit(1);
+// STREAM triad (a = b + s * c) over a footprint far larger than the LLC,
+// so the task is limited by memory bandwidth instead of the core.
+void perform_stream(long footprint_kb, int repeat) {
+    size_t count = (size_t)footprint_kb * 1024 / (3 * sizeof(double));
+    double *a = alloc_aligned(count * sizeof(double));
+    double *b = alloc_aligned(count * sizeof(double));
+    double *c = alloc_aligned(count * sizeof(double));
+    const double scalar = 3.0;
+
+    for(size_t i = 0; i < count; i++) {
+        a[i] = 0.0;
+        b[i] = 1.0;
+        c[i] = 2.0;
     }
 
-    // Set the time quantum for RT_RR before forking the child processes
-    int time_quantum = 0;
-    if (policy == 4) {
-        printf("Enter Time Slice for RT_RR (10, 100, or 1000 ms): ");
-        scanf("%d", &time_quantum);
-        FILE *fp = fopen("/proc/sys/kernel/sched_rr_timeslice_ms", "w");
-        if (fp == NULL) {
-            perror("Failed to open sched_rr_timeslice_ms");
-            exit(1);
+    for(int pass = 0; pass < repeat; pass++) {
+        for(size_t i = 0; i < count; i++) {
+            a[i] = b[i] + scalar * c[i];
         }
-        fprintf(fp, "%d", time_quantum);
-        fclose(fp);
     }
 
-    for(int i = 0; i < NUM_PROCESSES; i++) {
-        pid_t pid = fork();
+    workload_sink = a[count / 2];
+    free(a);
+    free(b);
+    free(c);
+}
 
-        if(pid == 0) { // Child process
-            close(pipefd[0]);
+// Follows a random single-cycle permutation of cache-line sized nodes.
+// Every load depends on the previous one, so the task measures memory latency.
+void perform_pointer_chase(long footprint_kb, int repeat) {
+    typedef struct Node {
+        struct Node *next;
+        char pad[CACHE_LINE_SIZE - sizeof(struct Node *)];
+    } Node;
 
-            struct timeval start, end;
-            gettimeofday(&start, NULL);
+    size_t count = (size_t)footprint_kb * 1024 / sizeof(Node);
+    Node *nodes = alloc_aligned(count * sizeof(Node));
+    size_t *order = malloc(count * sizeof(size_t));
+    if (order == NULL) {
+        perror("Workload allocation failed");
+        exit(EXIT_FAILURE);
+    }
 
-            int current_nice_value = 0; // default value
+    // Sattolo's shuffle yields one cycle through every node
+    uint64_t state = 0x9E3779B97F4A7C15ULL ^ (uint64_t)getpid();
+    for(size_t i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    for(size_t i = count - 1; i > 0; i--) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        size_t j = state % i;
+        size_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+    for(size_t i = 0; i < count; i++) {
+        nodes[order[i]].next = &nodes[order[(i + 1) % count]];
+    }
+    free(order);
 
-            switch(policy) {
-                case 1: // CFS_DEFAULT
-                    break;
-                case 2: // CFS_NICE
-                    if(i < 7) {
-                        setpriority(PRIO_PROCESS, 0, -20);
-                        current_nice_value = -20;
-                    }
-                    else if(i < 14) {
-                        setpriority(PRIO_PROCESS, 0, 0);
-                        current_nice_value = 0;
-                    }
-                    else {
-                        setpriority(PRIO_PROCESS, 0, 19);
-                        current_nice_value = 19;
-                    }
-                    break;
-                case 3: // RT_FIFO
-                    param.sched_priority = sched_get_priority_max(SCHED_FIFO);
-                    sched_setscheduler(0, SCHED_FIFO, &param);
-                    break;
-                case 4: // RT_RR
-                    param.sched_priority = sched_get_priority_max(SCHED_RR);
-                    sched_setscheduler(0, SCHED_RR, &param);
-                    break;
-                default:
-                    printf("Invalid policy choice.\n");
-                    exit(1);
+    Node *cursor = &nodes[0];
+    for(size_t step = 0; step < count * (size_t)repeat; step++) {
+        cursor = cursor->next;
+    }
+
+    workload_sink = (double)(uintptr_t)cursor;
+    free(nodes);
+}
+
+// Short CPU bursts separated by sleeps, like an interactive or request-driven task.
+// The task blocks voluntarily, so it tests how each policy treats wakeups.
+void perform_interactive(long burst_usec, int repeat) {
+    struct timespec pause = {
+        (burst_usec * INTERACTIVE_SLEEP_RATIO) / 1000000,
+        ((burst_usec * INTERACTIVE_SLEEP_RATIO) % 1000000) * 1000
+    };
+    double value = 0.0;
+
+    for(int count = 0; count < repeat; count++) {
+        struct timespec start, now;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        do {
+            for(int i = 0; i < 1000; i++) {
+                value = value * 0.999 + i;
             }
+            clock_gettime(CLOCK_MONOTONIC, &now);
+        } while((now.tv_sec - start.tv_sec) * 1000000L + (now.tv_nsec - start.tv_nsec) / 1000 < burst_usec);
+
+        while(nanosleep(&pause, &pause) == -1 && errno == EINTR) {
+        }
+        pause.tv_sec = (burst_usec * INTERACTIVE_SLEEP_RATIO) / 1000000;
+        pause.tv_nsec = ((burst_usec * INTERACTIVE_SLEEP_RATIO) % 1000000) * 1000;
+    }
+
+    workload_sink = value;
+}
 
+void perform_workload(const Workload *workload) {
+    switch(workload->kind) {
+        case WORKLOAD_MATRIX:
             perform_matrix_operation();
+            break;
+        case WORKLOAD_GEMM:
+            perform_blocked_gemm((int)workload->size, workload->repeat);
+            break;
+        case WORKLOAD_STREAM:
+            perform_stream(workload->size, workload->repeat);
+            break;
+        case WORKLOAD_CHASE:
+            perform_pointer_chase(workload->size, workload->repeat);
+            break;
+        case WORKLOAD_INTERACTIVE:
+            perform_interactive(workload->size, workload->repeat);
+            break;
+    }
+}
 
-            gettimeofday(&end, NULL);
-            long elapsed_time = ((end.tv_sec - start.tv_sec) * 1000000) + (end.tv_usec - start.tv_usec);
-            double elapsed_seconds = elapsed_time / 1000000.0;
+static long long monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+// /proc/<tid>/schedstat holds "cpu time, run-queue wait, timeslices" in ns for one task
+static long long read_run_delay(pid_t tid) {
+    char path[64];
+    unsigned long long cpu_ns, wait_ns;
+
+    snprintf(path, sizeof(path), "/proc/self/task/%d/schedstat", (int)tid);
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        return -1;
+    }
+    int fields = fscanf(fp, "%llu %llu", &cpu_ns, &wait_ns);
+    fclose(fp);
+    return fields == 2 ? (long long)wait_ns : -1;
+}
+
+// se.nr_migrations in /proc/<tid>/sched counts how often the scheduler moved the task between CPUs
+static long read_migrations(pid_t tid) {
+    char path[64], line[256];
+    long migrations = -1;
 
-            ProcessInfo pInfo;
-            pInfo.pid = getpid();
-            pInfo.nice_value = current_nice_value;
-            struct tm *tm_info;
+    snprintf(path, sizeof(path), "/proc/self/task/%d/sched", (int)tid);
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        return -1;
+    }
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (strncmp(line, "se.nr_migrations", 16) == 0) {
+            char *colon = strchr(line, ':');
+            migrations = colon != NULL ? atol(colon + 1) : -1;
+            break;
+        }
+    }
+    fclose(fp);
+    return migrations;
+}
 
-            tm_info = localtime(&start.tv_sec);
-            strftime(pInfo.start_time, 26, "%Y-%m-%d %H:%M:%S", tm_info);
-            pInfo.start_usec = start.tv_usec;
+static void take_sample(TaskSample *sample, pid_t tid, int thread_mode) {
+    sample->run_delay_ns = read_run_delay(tid);
+    sample->migrations = read_migrations(tid);
+    getrusage(thread_mode ? RUSAGE_THREAD : RUSAGE_SELF, &sample->usage);
+    sample->time_ns = monotonic_ns();
+}
 
-            tm_info = localtime(&end.tv_sec);
-            strftime(pInfo.end_time, 26, "%Y-%m-%d %H:%M:%S", tm_info);
-            pInfo.end_usec = end.tv_usec;
+static int perf_open(unsigned long long config, int group_fd) {
+    struct perf_event_attr attr;
 
-            pInfo.elapsed_seconds = elapsed_seconds;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group_fd == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    // pid 0, cpu -1: count the calling thread on whatever CPU it runs
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
 
-            if(write(pipefd[1], &pInfo, sizeof(ProcessInfo)) == -1) {
-                perror("Write to pipe failed");
-                exit(EXIT_FAILURE);
+static void perf_counters_start(PerfCounters *counters) {
+    counters->instructions_fd = -1;
+    counters->leader_fd = perf_open(PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (counters->leader_fd == -1) {
+        return;
+    }
+    counters->instructions_fd = perf_open(PERF_COUNT_HW_INSTRUCTIONS, counters->leader_fd);
+    if (counters->instructions_fd == -1) {
+        close(counters->leader_fd);
+        counters->leader_fd = -1;
+        return;
+    }
+    ioctl(counters->leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(counters->leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+static void perf_counters_stop(PerfCounters *counters, ProcessInfo *pInfo) {
+    struct { uint64_t count; uint64_t values[2]; } group;
+
+    pInfo->cycles = pInfo->instructions = -1;
+    if (counters->leader_fd == -1) {
+        return;
+    }
+    ioctl(counters->leader_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    if (read(counters->leader_fd, &group, sizeof(group)) == (ssize_t)sizeof(group) && group.count == 2) {
+        pInfo->cycles = (long long)group.values[0];
+        pInfo->instructions = (long long)group.values[1];
+    }
+    close(counters->instructions_fd);
+    close(counters->leader_fd);
+}
+
+static double timeval_seconds(struct timeval end, struct timeval start) {
+    return (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1000000.0;
+}
+
+// Parses a sysfs CPU list such as "0-3,8-11" into set
+static int parse_cpulist(const char *text, cpu_set_t *set) {
+    CPU_ZERO(set);
+    while (*text != '\0' && *text != '\n') {
+        char *end;
+        long first = strtol(text, &end, 10), last = first;
+        if (end == text) {
+            return -1;
+        }
+        if (*end == '-') {
+            text = end + 1;
+            last = strtol(text, &end, 10);
+            if (end == text) {
+                return -1;
             }
+        }
+        for(long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+            CPU_SET(cpu, set);
+        }
+        text = *end == ',' ? end + 1 : end;
+    }
+    return 0;
+}
+
+static int read_cpulist(const char *path, cpu_set_t *set) {
+    char buffer[1024];
+    FILE *fp = fopen(path, "r");
 
-            close(pipefd[1]);
-            exit(0);
+    if (fp == NULL) {
+        return -1;
+    }
+    char *line = fgets(buffer, sizeof(buffer), fp);
+    fclose(fp);
+    return line != NULL ? parse_cpulist(line, set) : -1;
+}
+
+static void format_cpuset(const cpu_set_t *set, char *buffer, size_t size) {
+    size_t used = 0;
+    buffer[0] = '\0';
+    for(int cpu = 0; cpu < CPU_SETSIZE && used < size; cpu++) {
+        if (!CPU_ISSET(cpu, set)) {
+            continue;
         }
-        else if(pid < 0) {
-            perror("Fork failed");
-            exit(EXIT_FAILURE);
+        int last = cpu;
+        while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, set)) {
+            last++;
         }
-        else {
-            child_pids[i] = pid;
+        used += snprintf(buffer + used, size - used, used > 0 ? ",%d" : "%d", cpu);
+        if (last > cpu && used < size) {
+            used += snprintf(buffer + used, size - used, "-%d", last);
         }
+        cpu = last;
     }
+}
 
-    close(pipefd[1]);
+// Builds the affinity of every worker from the CPUs this process may use, so runs inside a
+// cpuset or under taskset stay within it. NUMA nodes come from sysfs like libnuma reads them.
+static int plan_placement(BenchConfig *config) {
+    cpu_set_t allowed;
+    int allowed_cpus[CPU_SETSIZE], allowed_count = 0;
 
-    ProcessInfo pInfoArray[NUM_PROCESSES];
+    if (config->placement == PLACEMENT_FREE) {
+        return 0;
+    }
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == -1) {
+        perror("sched_getaffinity failed");
+        return -1;
+    }
+    for(int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            allowed_cpus[allowed_count++] = cpu;
+        }
+    }
 
-    for(int i = 0; i < NUM_PROCESSES; i++) {
-        if(read(pipefd[0], &pInfoArray[i], sizeof(ProcessInfo)) == -1) {
-            perror("Read from pipe failed");
-            exit(EXIT_FAILURE);
+    config->worker_cpus = calloc(config->num_workers, sizeof(cpu_set_t));
+    config->worker_nodes = malloc(config->num_workers * sizeof(int));
+    if (config->worker_cpus == NULL || config->worker_nodes == NULL) {
+        perror("Placement allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    for(int i = 0; i < config->num_workers; i++) {
+        config->worker_nodes[i] = -1;
+    }
+
+    if (config->placement == PLACEMENT_SINGLE) {
+        int cpu = config->placement_arg >= 0 ? config->placement_arg : allowed_cpus[0];
+        if (cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed)) {
+            fprintf(stderr, "CPU %d is not available to this process\n", cpu);
+            return -1;
+        }
+        for(int i = 0; i < config->num_workers; i++) {
+            CPU_SET(cpu, &config->worker_cpus[i]);
+        }
+    }
+    else if (config->placement == PLACEMENT_CORES) {
+        if (config->placement_arg > allowed_count) {
+            fprintf(stderr, "Only %d CPUs are available to this process\n", allowed_count);
+            return -1;
+        }
+        for(int i = 0; i < config->num_workers; i++) {
+            for(int c = 0; c < config->placement_arg; c++) {
+                CPU_SET(allowed_cpus[c], &config->worker_cpus[i]);
+            }
+        }
+    }
+    else {
+        cpu_set_t online, node_cpus[64];
+        int nodes[64], node_count = 0;
+
+        if (read_cpulist("/sys/devices/system/node/online", &online) == 0) {
+            for(int node = 0; node < 64; node++) {
+                char path[64];
+                if (!CPU_ISSET(node, &online)) {
+                    continue;
+                }
+                snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+                if (read_cpulist(path, &node_cpus[node_count]) == 0) {
+                    CPU_AND(&node_cpus[node_count], &node_cpus[node_count], &allowed);
+                    if (CPU_COUNT(&node_cpus[node_count]) > 0) {
+                        nodes[node_count++] = node;
+                    }
+                }
+            }
+        }
+        if (node_count == 0) {
+            fprintf(stderr, "No NUMA topology in sysfs, treating all CPUs as one node\n");
+            node_cpus[0] = allowed;
+            nodes[node_count++] = 0;
+        }
+        for(int i = 0; i < config->num_workers; i++) {
+            config->worker_cpus[i] = node_cpus[i % node_count];
+            config->worker_nodes[i] = nodes[i % node_count];
         }
-        wait(NULL); // Wait for all child processes to finish
     }
+    return 0;
+}
+
+// Called by each worker on itself; in thread mode both calls only affect the calling thread
+static void apply_placement(const BenchConfig *config, int index) {
+    if (config->worker_cpus == NULL) {
+        return;
+    }
+    if (sched_setaffinity(0, sizeof(cpu_set_t), &config->worker_cpus[index]) == -1) {
+        perror("sched_setaffinity failed");
+    }
+    if (config->worker_nodes[index] >= 0) {
+        unsigned long nodemask = 1UL << config->worker_nodes[index];
+        // Best effort: the kernel may lack NUMA support, the CPU binding still applies
+        syscall(SYS_set_mempolicy, MPOL_PREFERRED, &nodemask, sizeof(nodemask) * 8);
+    }
+}
+
+int compare_nice(const void *a, const void *b) {
+    return ((ProcessInfo *)a)->nice_value - ((ProcessInfo *)b)->nice_value;
+}
+
+double total_elapsed_seconds = 0.0;
+
+// Gives every group without an explicit count an even share of the remaining workers.
+// Earlier groups take the remainder, so 21 workers over three groups split 7/7/7 as before.
+static int resolve_nice_groups(BenchConfig *config) {
+    int claimed = 0, shared = 0;
 
-    close(pipefd[0]);
+    for(int g = 0; g < config->nice_group_count; g++) {
+        claimed += config->nice_groups[g].count;
+        shared += config->nice_groups[g].count == 0;
+    }
+    if (claimed > config->num_workers || (shared == 0 && claimed != config->num_workers)) {
+        fprintf(stderr, "Nice group counts (%d) do not match the worker count (%d)\n", claimed, config->num_workers);
+        return -1;
+    }
 
-    if(policy == 2) { // CFS_NICE
-        qsort(pInfoArray, NUM_PROCESSES, sizeof(ProcessInfo), compare_nice);
+    int remaining = config->num_workers - claimed;
+    for(int g = 0; g < config->nice_group_count && shared > 0; g++) {
+        if (config->nice_groups[g].count == 0) {
+            int share = (remaining + shared - 1) / shared;
+            config->nice_groups[g].count = share;
+            remaining -= share;
+            shared--;
+        }
     }
+    return 0;
+}
 
-    for(int i = 0; i < NUM_PROCESSES; i++) {
-    printf("PID: %d", pInfoArray[i].pid);
-    // Print Nice value only for CFS_DEFAULT and CFS_NICE
-    if (policy == 1 || policy == 2) {
-        printf(" | Nice: %d", pInfoArray[i].nice_value);
+static int nice_for_worker(const BenchConfig *config, int index) {
+    for(int g = 0; g < config->nice_group_count; g++) {
+        if (index < config->nice_groups[g].count) {
+            return config->nice_groups[g].nice_value;
+        }
+        index -= config->nice_groups[g].count;
     }
-    printf(" | Start time: %s.%06ld | End time: %s.%06ld | Elapsed time: %.6f\n",
-        pInfoArray[i].start_time,
-        pInfoArray[i].start_usec,
-        pInfoArray[i].end_time,
-        pInfoArray[i].end_usec,
-        pInfoArray[i].elapsed_seconds);
+    return 0;
+}
 
-    total_elapsed_time += pInfoArray[i].elapsed_seconds;
+static int rt_policy(Policy policy) {
+    return policy == POLICY_RT_FIFO ? SCHED_FIFO : SCHED_RR;
 }
 
-    printf("Scheduling Policy: ");
-    switch(policy) {
-        case 1:
-            printf("CFS_DEFAULT");
+static TaskClass class_for_worker(const BenchConfig *config, int index) {
+    TaskClass cls = { config->policy, 1, 0, 0, 0, 0, 0 };
+
+    switch(config->policy) {
+        case POLICY_CFS_NICE:
+            cls.nice_value = nice_for_worker(config, index);
             break;
-        case 2:
-            printf("CFS_NICE");
+        case POLICY_RT_FIFO:
+        case POLICY_RT_RR:
+            cls.rt_priority = sched_get_priority_max(rt_policy(config->policy));
             break;
-        case 3:
-            printf("RT_FIFO");
+        case POLICY_DEADLINE:
+            cls = config->deadline;
             break;
-        case 4:
-            printf("RT_RR");
-            // Print the chosen time quantum for RT_RR
-            if (time_quantum > 0) {
-                printf(" | Time Quantum: %d ms", time_quantum);
+        case POLICY_MIXED:
+            for(int g = 0; g < config->class_count; g++) {
+                if (index < config->classes[g].count) {
+                    return config->classes[g];
+                }
+                index -= config->classes[g].count;
             }
             break;
         default:
-            printf("Invalid");
+            break;
     }
-    printf(" | Average elapsed time: %.6lf\n", total_elapsed_time / NUM_PROCESSES);
+    return cls;
+}
 
+// Switches the calling thread (and so a single-threaded worker process) to cls.
+// Returns 0 or the errno of the refused call; SCHED_DEADLINE fails with EBUSY when the
+// requested bandwidth does not pass the kernel's admission control.
+static int apply_policy(const TaskClass *cls, pid_t tid) {
+    struct sched_param param = { 0 };
+    int result = 0;
+
+    switch(cls->policy) {
+        case POLICY_CFS_DEFAULT:
+        case POLICY_CFS_NICE:
+            break;
+        case POLICY_BATCH:
+            result = sched_setscheduler(0, SCHED_BATCH, &param);
+            break;
+        case POLICY_IDLE:
+            result = sched_setscheduler(0, SCHED_IDLE, &param);
+            break;
+        case POLICY_RT_FIFO:
+        case POLICY_RT_RR:
+            param.sched_priority = cls->rt_priority;
+            result = sched_setscheduler(0, rt_policy(cls->policy), &param);
+            break;
+        case POLICY_DEADLINE: {
+            SchedAttr attr = { sizeof(SchedAttr), SCHED_DEADLINE, 0, 0, 0, cls->runtime_ns, cls->deadline_ns, cls->period_ns };
+            result = (int)syscall(SYS_sched_setattr, 0, &attr, 0);
+            break;
+        }
+        case POLICY_MIXED:
+            break;
+    }
+    if (result == -1) {
+        return errno;
+    }
+    // The nice value of CFS and BATCH workers, set on the tid so it stays per thread
+    if ((cls->policy == POLICY_CFS_NICE || cls->policy == POLICY_CFS_DEFAULT || cls->policy == POLICY_BATCH) && cls->nice_value != 0
+        && setpriority(PRIO_PROCESS, tid, cls->nice_value) == -1) {
+        return errno;
+    }
     return 0;
 }
 
+// Body shared by both execution modes. Every worker switches its own class; the only
+// exception is a uniform RT_FIFO/RT_RR thread run, where the threads were created with explicit
+// scheduling attributes and create_errno says whether run_threads had to fall back to inherited ones.
+// Placement is applied first; SCHED_DEADLINE is only admitted with free placement (see
+// parse_command_line), since the kernel refuses it for a task pinned to part of its root domain.
+// Every worker waits at the start barrier after its policy is in place, and elapsed time is
+// measured from the barrier release, so it no longer depends on when each worker was forked.
+// The counters are sampled before the barrier: the wait for a CPU after the release counts as
+// run delay, and blocking in the barrier adds one voluntary context switch.
+static void run_worker(const BenchConfig *config, int index, SharedResults *shared, int create_errno) {
+    TaskSample start, end;
+    PerfCounters counters;
+    ProcessInfo *pInfo = &shared->slots[index].info;
+    TaskClass cls = class_for_worker(config, index);
+    pid_t tid = (pid_t)syscall(SYS_gettid);
+
+    apply_placement(config, index);
+    pInfo->policy_errno = create_errno;
+    if (config->mode == MODE_PROCESS || (config->policy != POLICY_RT_FIFO && config->policy != POLICY_RT_RR)) {
+        pInfo->policy_errno = apply_policy(&cls, tid);
+    }
+
+    perf_counters_start(&counters);
+    take_sample(&start, tid, config->mode == MODE_THREAD);
+    pthread_barrier_wait(&shared->start_barrier);
+    start.time_ns = monotonic_ns();
+    pInfo->start_cpu = sched_getcpu();
+    if (config->latency_window != NULL) {
+        atomic_store(&config->latency_window->released, 1);
+    }
+
+    perform_workload(&config->workload);
+
+    if (config->latency_window != NULL) {
+        atomic_fetch_add(&config->latency_window->finished, 1);
+    }
+
+    take_sample(&end, tid, config->mode == MODE_THREAD);
+    pInfo->end_cpu = sched_getcpu();
+    perf_counters_stop(&counters, pInfo);
+
+    pInfo->pid = tid;
+    pInfo->nice_value = cls.nice_value;
+    pInfo->policy = cls.policy;
+    pInfo->start_ns = start.time_ns;
+    pInfo->end_ns = end.time_ns;
+    pInfo->user_seconds = timeval_seconds(end.usage.ru_utime, start.usage.ru_utime);
+    pInfo->system_seconds = timeval_seconds(end.usage.ru_stime, start.usage.ru_stime);
+    pInfo->voluntary_switches = end.usage.ru_nvcsw - start.usage.ru_nvcsw;
+    pInfo->involuntary_switches = end.usage.ru_nivcsw - start.usage.ru_nivcsw;
+    pInfo->run_delay_ns = start.run_delay_ns >= 0 && end.run_delay_ns >= 0 ? end.run_delay_ns - start.run_delay_ns : -1;
+    pInfo->migrations = start.migrations >= 0 && end.migrations >= 0 ? end.migrations - start.migrations : -1;
+    pInfo->node = config->worker_nodes != NULL ? config->worker_nodes[index] : -1;
+    shared->slots[index].valid = 1;
+}
+
+static size_t shared_results_size(int num_workers) {
+    return sizeof(SharedResults) + (size_t)num_workers * sizeof(ResultSlot);
+}
+
+static SharedResults *shared_results_create(int num_workers) {
+    SharedResults *shared = mmap(NULL, shared_results_size(num_workers), PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    pthread_barrierattr_t attr;
+
+    if (shared == MAP_FAILED) {
+        perror("Shared result mapping failed");
+        exit(EXIT_FAILURE);
+    }
+    pthread_barrierattr_init(&attr);
+    pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    if (pthread_barrier_init(&shared->start_barrier, &attr, num_workers) != 0) {
+        perror("Barrier creation failed");
+        exit(EXIT_FAILURE);
+    }
+    pthread_barrierattr_destroy(&attr);
+    return shared;
+}
+
+static void shared_results_destroy(SharedResults *shared, int num_workers) {
+    pthread_barrier_destroy(&shared->start_barrier);
+    munmap(shared, shared_results_size(num_workers));
+}
+
+static void latency_reset(LatencyHistogram *histogram) {
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->min_ns = -1;
+}
+
+static void latency_record(LatencyHistogram *histogram, long long latency_ns) {
+    long long bucket = latency_ns / 1000;
+
+    histogram->samples++;
+    histogram->sum_ns += latency_ns;
+    if (histogram->min_ns < 0 || latency_ns < histogram->min_ns) {
+        histogram->min_ns = latency_ns;
+    }
+    if (latency_ns > histogram->max_ns) {
+        histogram->max_ns = latency_ns;
+    }
+    if (bucket < LATENCY_HISTOGRAM_US) {
+        histogram->buckets[bucket]++;
+    }
+    else {
+        histogram->overflow++;
+    }
+}
+
+static void latency_merge(LatencyHistogram *into, const LatencyHistogram *from) {
+    if (from->samples == 0) {
+        return;
+    }
+    if (into->min_ns < 0 || from->min_ns < into->min_ns) {
+        into->min_ns = from->min_ns;
+    }
+    if (from->max_ns > into->max_ns) {
+        into->max_ns = from->max_ns;
+    }
+    into->samples += from->samples;
+    into->sum_ns += from->sum_ns;
+    into->overflow += from->overflow;
+    for(int b = 0; b < LATENCY_HISTOGRAM_US; b++) {
+        into->buckets[b] += from->buckets[b];
+    }
+}
+
+// Upper edge in usec of the bucket holding the p-th percentile; the maximum once it falls into the overflow
+static double latency_percentile(const LatencyHistogram *histogram, double p) {
+    long long rank = (long long)ceil(p / 100.0 * histogram->samples), seen = 0;
+    for(int b = 0; b < LATENCY_HISTOGRAM_US; b++) {
+        seen += histogram->buckets[b];
+        if (seen >= rank) {
+            return b + 1;
+        }
+    }
+    return histogram->max_ns / 1000.0;
+}
+
+// Sleeps to absolute deadlines one interval apart like cyclictest and records how late each wakeup was.
+// Overruns are not skipped, so a long stall also shows up as the late wakeups queued behind it.
+// Only wakeups while the load runs are recorded, and the timer is placed like the worker it shadows
+// so that -a confines it to the CPUs under contention.
+static void *timer_thread(void *arg) {
+    TimerThread *timer = arg;
+    LatencyWindow *window = timer->config->latency_window;
+    struct timespec next, now;
+
+    apply_placement(timer->config, timer->worker);
+    timer->policy_errno = apply_policy(&timer->cls, (pid_t)syscall(SYS_gettid));
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (!atomic_load(timer->stop)) {
+        next.tv_nsec += timer->interval_ns;
+        while (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR) {
+        }
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (atomic_load(&window->released) && atomic_load(&window->finished) < timer->config->num_workers) {
+            latency_record(&timer->histogram, (now.tv_sec - next.tv_sec) * 1000000000LL + (now.tv_nsec - next.tv_nsec));
+        }
+    }
+    return NULL;
+}
+
+// The timer threads belong to the parent and take the class under test (the first nice group
+// for CFS_NICE); the workers they compete with are the CPU-bound background load
+static TimerThread *start_timer_threads(const BenchConfig *config, atomic_int *stop) {
+    TimerThread *timers = calloc(config->latency_threads, sizeof(TimerThread));
+
+    if (timers == NULL) {
+        perror("Timer thread allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    atomic_store(stop, 0);
+    atomic_store(&config->latency_window->released, 0);
+    atomic_store(&config->latency_window->finished, 0);
+    for(int i = 0; i < config->latency_threads; i++) {
+        timers[i].config = config;
+        timers[i].worker = i % config->num_workers;
+        timers[i].cls = class_for_worker(config, 0);
+        timers[i].interval_ns = config->latency_interval_us * 1000LL;
+        timers[i].stop = stop;
+        latency_reset(&timers[i].histogram);
+        int rc = pthread_create(&timers[i].thread, NULL, timer_thread, &timers[i]);
+        if (rc != 0) {
+            fprintf(stderr, "Timer thread creation failed: %s\n", strerror(rc));
+            exit(EXIT_FAILURE);
+        }
+    }
+    return timers;
+}
+
+// Stops and joins the timer threads, merges their histograms into total and prints the trial line
+static void stop_timer_threads(const BenchConfig *config, TimerThread *timers, atomic_int *stop,
+                               LatencyHistogram *total, const char *label) {
+    int refused = 0;
+
+    atomic_store(stop, 1);
+    latency_reset(total);
+    for(int i = 0; i < config->latency_threads; i++) {
+        pthread_join(timers[i].thread, NULL);
+        latency_merge(total, &timers[i].histogram);
+        refused += timers[i].policy_errno != 0;
+    }
+    if (refused > 0) {
+        printf("%sWarning: %d of %d timer threads kept the default policy\n", label, refused, config->latency_threads);
+    }
+    printf("%sWakeup latency (%s, %d threads, %ld us interval): min %.1f | avg %.1f | p99 %.0f | max %.1f us | %lld samples, %lld over %d us\n",
+        label, policy_names[config->policy], config->latency_threads, config->latency_interval_us,
+        total->min_ns / 1000.0, total->samples ? total->sum_ns / 1000.0 / total->samples : 0.0,
+        total->samples ? latency_percentile(total, 99) : 0.0, total->max_ns / 1000.0,
+        total->samples, total->overflow, LATENCY_HISTOGRAM_US);
+    free(timers);
+}
+
+static void run_processes(const BenchConfig *config, SharedResults *shared) {
+    pid_t *child_pids = malloc(config->num_workers * sizeof(pid_t));
+
+    if (child_pids == NULL) {
+        perror("Process allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    for(int i = 0; i < config->num_workers; i++) {
+        pid_t pid = fork();
+
+        if(pid == 0) { // Child process
+            run_worker(config, i, shared, 0);
+            _exit(0); // exit() would flush the parent's buffered stdout once more per worker
+        }
+        else if(pid < 0) {
+            perror("Fork failed");
+            // The workers already forked would wait at the barrier forever
+            for(int j = 0; j < i; j++) {
+                kill(child_pids[j], SIGKILL);
+            }
+            exit(EXIT_FAILURE);
+        }
+        else {
+            child_pids[i] = pid;
+        }
+    }
+
+    for(int i = 0; i < config->num_workers; i++) {
+        while(waitpid(child_pids[i], NULL, 0) == -1 && errno == EINTR) {
+        }
+    }
+
+    free(child_pids);
+}
+
+typedef struct {
+    const BenchConfig *config;
+    int index;
+    SharedResults *shared;
+    int fell_back; // created without the RT attributes after EPERM
+} WorkerArgs;
+
+static void *worker_thread(void *arg) {
+    WorkerArgs *args = arg;
+    run_worker(args->config, args->index, args->shared, args->fell_back ? EPERM : 0);
+    return NULL;
+}
+
+static void run_threads(const BenchConfig *config, SharedResults *shared) {
+    pthread_t *threads = malloc(config->num_workers * sizeof(pthread_t));
+    WorkerArgs *args = malloc(config->num_workers * sizeof(WorkerArgs));
+    pthread_attr_t attr;
+    int fell_back = 0;
+
+    if (threads == NULL || args == NULL) {
+        perror("Thread allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    pthread_attr_init(&attr);
+    if (config->policy == POLICY_RT_FIFO || config->policy == POLICY_RT_RR) {
+        struct sched_param param;
+        param.sched_priority = sched_get_priority_max(rt_policy(config->policy));
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, rt_policy(config->policy));
+        pthread_attr_setschedparam(&attr, &param);
+    }
+
+    for(int i = 0; i < config->num_workers; i++) {
+        args[i].config = config;
+        args[i].index = i;
+        args[i].shared = shared;
+        args[i].fell_back = fell_back; // the attributes stay inherited once the RT ones were refused
+
+        int rc = pthread_create(&threads[i], &attr, worker_thread, &args[i]);
+        if (rc == EPERM) {
+            // Like sched_setscheduler() in process mode, an unprivileged run falls back to the default policy
+            fprintf(stderr, "No permission for %s threads, using the default policy\n", policy_names[config->policy]);
+            pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+            args[i].fell_back = fell_back = 1;
+            rc = pthread_create(&threads[i], &attr, worker_thread, &args[i]);
+        }
+        if (rc != 0) {
+            fprintf(stderr, "Thread creation failed: %s\n", strerror(rc));
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    for(int i = 0; i < config->num_workers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    pthread_attr_destroy(&attr);
+    free(threads);
+    free(args);
+}
+
+static int find_option(const char *text, const char **options, int count) {
+    for(int i = 1; i < count; i++) {
+        if (strcmp(text, options[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Parses a comma separated list of policy names such as "cfs,fifo,rr"
+static int parse_policies(const char *text, BenchConfig *config) {
+    char buffer[256];
+    int found;
+    config->policy_count = 0;
+
+    snprintf(buffer, sizeof(buffer), "%s", text);
+    for(char *item = strtok(buffer, ","); item != NULL; item = strtok(NULL, ",")) {
+        if ((found = find_option(item, policy_options, POLICY_COUNT + 1)) == -1 || config->policy_count == POLICY_COUNT) {
+            return -1;
+        }
+        config->policies[config->policy_count++] = found;
+    }
+    return config->policy_count > 0 ? 0 : -1;
+}
+
+// Parses "RUNTIME/DEADLINE/PERIOD" in microseconds; DEADLINE and PERIOD default to the one before
+static int parse_deadline(const char *text, TaskClass *cls) {
+    unsigned long long values[3] = { 0, 0, 0 };
+    int count = 0;
+    char *end;
+
+    while (count < 3) {
+        values[count] = strtoull(text, &end, 10);
+        if (end == text || values[count] == 0) {
+            return -1;
+        }
+        count++;
+        if (*end != '/') {
+            break;
+        }
+        text = end + 1;
+    }
+    if (*end != '\0') {
+        return -1;
+    }
+    for(int i = count; i < 3; i++) {
+        values[i] = values[i - 1];
+    }
+    // The kernel requires runtime <= deadline <= period
+    if (values[0] > values[1] || values[1] > values[2]) {
+        return -1;
+    }
+    cls->policy = POLICY_DEADLINE;
+    cls->runtime_ns = values[0] * 1000;
+    cls->deadline_ns = values[1] * 1000;
+    cls->period_ns = values[2] * 1000;
+    return 0;
+}
+
+// Parses a mixed workload "NAME:COUNT[:PARAM],..." where NAME is cfs, batch, idle, fifo, rr or
+// deadline and PARAM is the nice value (cfs, batch), RT priority (fifo, rr) or
+// RUNTIME/DEADLINE/PERIOD in microseconds (deadline), e.g. "deadline:2:5000/20000/20000,batch:18"
+static int parse_mix(const char *text, BenchConfig *config) {
+    char buffer[512];
+    config->class_count = 0;
+
+    snprintf(buffer, sizeof(buffer), "%s", text);
+    for(char *item = strtok(buffer, ","); item != NULL; item = strtok(NULL, ",")) {
+        char *count_text = strchr(item, ':'), *param = NULL, *end;
+        TaskClass cls = config->deadline;
+        int found;
+
+        if (count_text == NULL || config->class_count == MAX_CLASSES) {
+            return -1;
+        }
+        *count_text++ = '\0';
+        if ((param = strchr(count_text, ':')) != NULL) {
+            *param++ = '\0';
+        }
+        if ((found = find_option(item, policy_options, POLICY_COUNT + 1)) == -1 || found == POLICY_CFS_NICE) {
+            return -1;
+        }
+        cls.policy = found;
+        cls.nice_value = 0;
+        cls.rt_priority = found == POLICY_RT_FIFO || found == POLICY_RT_RR ? sched_get_priority_max(rt_policy(found)) : 0;
+        cls.count = (int)strtol(count_text, &end, 10);
+        if (end == count_text || *end != '\0' || cls.count < 1) {
+            return -1;
+        }
+        if (param != NULL) {
+            long value = strtol(param, &end, 10);
+            switch(cls.policy) {
+                case POLICY_CFS_DEFAULT:
+                case POLICY_BATCH:
+                    if (end == param || *end != '\0' || value < -20 || value > 19) {
+                        return -1;
+                    }
+                    cls.nice_value = (int)value;
+                    break;
+                case POLICY_RT_FIFO:
+                case POLICY_RT_RR:
+                    if (end == param || *end != '\0' || value < 1 || value > 99) {
+                        return -1;
+                    }
+                    cls.rt_priority = (int)value;
+                    break;
+                case POLICY_DEADLINE:
+                    if (parse_deadline(param, &cls) == -1) {
+                        return -1;
+                    }
+                    break;
+                default:
+                    return -1;
+            }
+        }
+        config->classes[config->class_count++] = cls;
+    }
+    return config->class_count > 0 ? 0 : -1;
+}
+
+// Parses "free", "single", "single:CPU", "cores:N" or "numa"
+static int parse_placement(const char *text, BenchConfig *config) {
+    const char *colon = strchr(text, ':');
+    size_t name_length = colon != NULL ? (size_t)(colon - text) : strlen(text);
+    char *end;
+
+    for(int i = 0; i < 4; i++) {
+        if (strlen(placement_names[i]) == name_length && strncmp(text, placement_names[i], name_length) == 0) {
+            config->placement = i;
+            config->placement_arg = -1;
+            if (colon == NULL) {
+                return i == PLACEMENT_CORES ? -1 : 0;
+            }
+            if (i != PLACEMENT_SINGLE && i != PLACEMENT_CORES) {
+                return -1;
+            }
+            config->placement_arg = (int)strtol(colon + 1, &end, 10);
+            return end != colon + 1 && *end == '\0' && config->placement_arg >= (i == PLACEMENT_CORES) ? 0 : -1;
+        }
+    }
+    return -1;
+}
+
+// Parses "LEVEL[:COUNT],..." such as "-20,0,19" or "-20:2,0,19:2"
+static int parse_nice_groups(const char *text, BenchConfig *config) {
+    char buffer[512];
+    config->nice_group_count = 0;
+
+    snprintf(buffer, sizeof(buffer), "%s", text);
+    for(char *item = strtok(buffer, ","); item != NULL; item = strtok(NULL, ",")) {
+        char *end;
+        NiceGroup group = { (int)strtol(item, &end, 10), 0 };
+
+        if (end == item || group.nice_value < -20 || group.nice_value > 19 || config->nice_group_count == MAX_NICE_GROUPS) {
+            return -1;
+        }
+        if (*end == ':') {
+            char *count_end;
+            group.count = (int)strtol(end + 1, &count_end, 10);
+            if (count_end == end + 1 || *count_end != '\0' || group.count < 1) {
+                return -1;
+            }
+        }
+        else if (*end != '\0') {
+            return -1;
+        }
+        config->nice_groups[config->nice_group_count++] = group;
+    }
+    return config->nice_group_count > 0 ? 0 : -1;
+}
+
+static void print_usage(const char *program) {
+    printf("Usage: %s [options]   (no options: interactive menu)\n"
+           "  -p, --policy LIST      cfs, nice, fifo, rr, batch, idle and/or deadline, compared one after another\n"
+           "                         (default: cfs)\n"
+           "  -D, --deadline R/D/P   SCHED_DEADLINE runtime/deadline/period in usec (default: %d/%d/%d)\n"
+           "  -x, --mix SPEC         one run mixing classes, NAME:COUNT[:PARAM],... with NAME cfs, batch, idle,\n"
+           "                         fifo, rr or deadline and PARAM a nice value, RT priority or R/D/P;\n"
+           "                         sets the worker count, e.g. deadline:2:5000/20000/20000,batch:18\n"
+           "  -q, --quantum MS       RT_RR time slice written to sched_rr_timeslice_ms\n"
+           "  -n, --workers N        number of workers, 1-%d (default: %d)\n"
+           "  -g, --nice LIST        nice groups for the nice policy as LEVEL[:COUNT],...\n"
+           "                         groups without a count share the rest evenly (default: -20,0,19)\n"
+           "  -m, --mode MODE        process (fork) or thread (pthread) workers (default: process)\n"
+           "  -k, --kernel NAME      matrix, gemm, stream, chase or interactive (default: matrix)\n"
+           "  -s, --size N           kernel size: GEMM order, STREAM/CHASE KB or INTERACTIVE burst usec\n"
+           "  -r, --repeat N         passes over the kernel (gemm, stream, chase, interactive)\n"
+           "  -a, --affinity MODE    free, single[:CPU], cores:N or numa (default: free, the only mode for deadline)\n"
+           "  -L, --latency N        also run N cyclictest-style timer threads under the policy, with the\n"
+           "                         workers as CFS background load, and report their wakeup latency\n"
+           "  -i, --interval US      timer thread period (default: %d)\n"
+           "  -H, --histogram FILE   write the 1 usec wakeup latency histogram of every policy to FILE\n"
+           "  -t, --trials N         measured trials per policy (default: 1)\n"
+           "  -w, --warmup N         warm-up trials run first and discarded (default: 0)\n"
+           "  -o, --output FILE      write per-policy statistics to FILE\n"
+           "  -f, --format FORMAT    csv or json (default: from the FILE extension, else csv)\n"
+           "  -h, --help             show this help\n",
+           program, DEADLINE_DEFAULT_RUNTIME_US, DEADLINE_DEFAULT_PERIOD_US, DEADLINE_DEFAULT_PERIOD_US,
+           MAX_WORKERS, NUM_PROCESSES, LATENCY_DEFAULT_INTERVAL_US);
+}
+
+static int parse_command_line(int argc, char *argv[], BenchConfig *config) {
+    static const struct option long_options[] = {
+        { "policy", required_argument, NULL, 'p' },
+        { "deadline", required_argument, NULL, 'D' },
+        { "mix", required_argument, NULL, 'x' },
+        { "quantum", required_argument, NULL, 'q' },
+        { "workers", required_argument, NULL, 'n' },
+        { "nice", required_argument, NULL, 'g' },
+        { "mode", required_argument, NULL, 'm' },
+        { "kernel", required_argument, NULL, 'k' },
+        { "size", required_argument, NULL, 's' },
+        { "repeat", required_argument, NULL, 'r' },
+        { "affinity", required_argument, NULL, 'a' },
+        { "latency", required_argument, NULL, 'L' },
+        { "interval", required_argument, NULL, 'i' },
+        { "histogram", required_argument, NULL, 'H' },
+        { "trials", required_argument, NULL, 't' },
+        { "warmup", required_argument, NULL, 'w' },
+        { "output", required_argument, NULL, 'o' },
+        { "format", required_argument, NULL, 'f' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    long size = 0;
+    int repeat = 0, option, found;
+    const char *mix_text = NULL;
+
+    config->policy_count = 0;
+
+    while ((option = getopt_long(argc, argv, "p:D:x:q:n:g:m:k:s:r:a:L:i:H:t:w:o:f:h", long_options, NULL)) != -1) {
+        switch(option) {
+            case 'p':
+                if (parse_policies(optarg, config) == -1) {
+                    fprintf(stderr, "Invalid policy list: %s\n", optarg);
+                    return -1;
+                }
+                break;
+            case 'D':
+                if (parse_deadline(optarg, &config->deadline) == -1) {
+                    fprintf(stderr, "Invalid deadline parameters: %s\n", optarg);
+                    return -1;
+                }
+                break;
+            case 'x':
+                mix_text = optarg;
+                break;
+            case 'q':
+                config->time_quantum = atoi(optarg);
+                break;
+            case 'n':
+                config->num_workers = atoi(optarg);
+                break;
+            case 'g':
+                if (parse_nice_groups(optarg, config) == -1) {
+                    fprintf(stderr, "Invalid nice groups: %s\n", optarg);
+                    return -1;
+                }
+                break;
+            case 'm':
+                if (strcmp(optarg, "process") == 0) {
+                    config->mode = MODE_PROCESS;
+                }
+                else if (strcmp(optarg, "thread") == 0) {
+                    config->mode = MODE_THREAD;
+                }
+                else {
+                    fprintf(stderr, "Unknown mode: %s\n", optarg);
+                    return -1;
+                }
+                break;
+            case 'k':
+                if ((found = find_option(optarg, workload_options, 6)) == -1) {
+                    fprintf(stderr, "Unknown kernel: %s\n", optarg);
+                    return -1;
+                }
+                config->workload = workload_defaults[found];
+                break;
+            case 's':
+                size = atol(optarg);
+                break;
+            case 'r':
+                repeat = atoi(optarg);
+                break;
+            case 'a':
+                if (parse_placement(optarg, config) == -1) {
+                    fprintf(stderr, "Invalid affinity mode: %s\n", optarg);
+                    return -1;
+                }
+                break;
+            case 'L':
+                config->latency_threads = atoi(optarg);
+                break;
+            case 'i':
+                config->latency_interval_us = atol(optarg);
+                break;
+            case 'H':
+                config->histogram_path = optarg;
+                break;
+            case 't':
+                config->trials = atoi(optarg);
+                break;
+            case 'w':
+                config->warmup = atoi(optarg);
+                break;
+            case 'o':
+                config->export_path = optarg;
+                break;
+            case 'f':
+                if (strcmp(optarg, "csv") == 0) {
+                    config->export_format = EXPORT_CSV;
+                }
+                else if (strcmp(optarg, "json") == 0) {
+                    config->export_format = EXPORT_JSON;
+                }
+                else {
+                    fprintf(stderr, "Unknown format: %s\n", optarg);
+                    return -1;
+                }
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                exit(0);
+            default:
+                print_usage(argv[0]);
+                return -1;
+        }
+    }
+
+    if (optind < argc) {
+        fprintf(stderr, "Unexpected argument: %s\n", argv[optind]);
+        return -1;
+    }
+    // Parsed last so deadline groups without their own parameters pick up -D
+    if (mix_text != NULL) {
+        if (config->policy_count > 0) {
+            fprintf(stderr, "Use either --policy or --mix\n");
+            return -1;
+        }
+        if (parse_mix(mix_text, config) == -1) {
+            fprintf(stderr, "Invalid mix: %s\n", mix_text);
+            return -1;
+        }
+        config->policies[config->policy_count++] = POLICY_MIXED;
+        config->num_workers = 0;
+        for(int g = 0; g < config->class_count; g++) {
+            config->num_workers += config->classes[g].count;
+        }
+    }
+    if (config->policy_count == 0) {
+        config->policies[config->policy_count++] = POLICY_CFS_DEFAULT;
+    }
+    // SCHED_DEADLINE admission needs an affinity covering the whole root domain, so the kernel
+    // refuses it (EPERM) for a pinned task, whichever of the two is set first
+    int uses_deadline = 0;
+    for(int i = 0; i < config->policy_count; i++) {
+        uses_deadline |= config->policies[i] == POLICY_DEADLINE;
+    }
+    for(int g = 0; g < config->class_count; g++) {
+        uses_deadline |= config->classes[g].policy == POLICY_DEADLINE;
+    }
+    if (uses_deadline && config->placement != PLACEMENT_FREE) {
+        fprintf(stderr, "The deadline policy needs --affinity free: the kernel refuses SCHED_DEADLINE for pinned tasks\n");
+        return -1;
+    }
+    if (config->latency_threads < 0 || config->latency_threads > MAX_LATENCY_THREADS || config->latency_interval_us < 1) {
+        fprintf(stderr, "Latency mode needs 0-%d threads and an interval of at least 1 usec\n", MAX_LATENCY_THREADS);
+        return -1;
+    }
+    if (config->latency_threads > 0 && mix_text != NULL) {
+        fprintf(stderr, "Latency mode runs the timer threads under one policy and cannot be combined with --mix\n");
+        return -1;
+    }
+    if (config->histogram_path != NULL && config->latency_threads == 0) {
+        fprintf(stderr, "--histogram needs --latency\n");
+        return -1;
+    }
+    if (config->num_workers < 1 || config->num_workers > MAX_WORKERS) {
+        fprintf(stderr, "Worker count must be between 1 and %d\n", MAX_WORKERS);
+        return -1;
+    }
+    if (size < 0 || repeat < 0 || config->time_quantum < 0 || config->warmup < 0) {
+        fprintf(stderr, "Sizes, repeats, warm-up trials and the time quantum must not be negative\n");
+        return -1;
+    }
+    if (config->trials < 1) {
+        fprintf(stderr, "At least one measured trial is needed\n");
+        return -1;
+    }
+    if (config->export_path != NULL && config->export_format == EXPORT_NONE) {
+        const char *extension = strrchr(config->export_path, '.');
+        config->export_format = extension != NULL && strcmp(extension, ".json") == 0 ? EXPORT_JSON : EXPORT_CSV;
+    }
+    if (size > 0 && config->workload.kind != WORKLOAD_MATRIX) {
+        config->workload.size = size;
+    }
+    if (repeat > 0 && config->workload.kind != WORKLOAD_MATRIX) {
+        config->workload.repeat = repeat;
+    }
+    return 0;
+}
+
+static void read_interactive_config(BenchConfig *config) {
+    int policy;
+
+    printf("Choose a scheduling policy:\n");
+    printf("1. CFS_DEFAULT\n2. CFS_NICE\n3. RT_FIFO\n4. RT_RR\n5. BATCH\n6. IDLE\n7. DEADLINE\n0. Exit\n");
+    scanf("%d", &policy);
+
+    if (policy < 1 || policy > POLICY_COUNT) {
+        printf("Exiting program.\n");
+        exit(1);
+    }
+    config->policies[0] = policy;
+    config->policy_count = 1;
+
+    if (policy == POLICY_RT_RR) {
+        printf("Enter Time Slice for RT_RR (10, 100, or 1000 ms): ");
+        scanf("%d", &config->time_quantum);
+    }
+    if (policy == POLICY_DEADLINE) {
+        char parameters[64] = "";
+        printf("Enter runtime/deadline/period for DEADLINE in usec (e.g. %d/%d/%d): ",
+               DEADLINE_DEFAULT_RUNTIME_US, DEADLINE_DEFAULT_PERIOD_US, DEADLINE_DEFAULT_PERIOD_US);
+        scanf("%63s", parameters);
+        if (parse_deadline(parameters, &config->deadline) == -1) {
+            printf("Invalid deadline parameters.\n");
+            exit(1);
+        }
+    }
+
+    int workload_choice = WORKLOAD_MATRIX;
+    printf("Choose a workload kernel:\n");
+    printf("1. MATRIX (%dx%d int, L2 resident)\n2. GEMM_BLOCKED (cache-blocked, vectorized)\n"
+           "3. STREAM (memory bandwidth)\n4. POINTER_CHASE (memory latency)\n5. INTERACTIVE (CPU bursts + sleep)\n",
+           MATRIX_SIZE, MATRIX_SIZE);
+    scanf("%d", &workload_choice);
+
+    if (workload_choice < WORKLOAD_MATRIX || workload_choice > WORKLOAD_INTERACTIVE) {
+        printf("Invalid workload choice.\n");
+        exit(1);
+    }
+
+    config->workload = workload_defaults[workload_choice];
+    if (config->workload.kind != WORKLOAD_MATRIX) {
+        long size = 0;
+        printf("Enter %s size (%s, 0 for default %ld): ", workload_names[config->workload.kind],
+               workload_units[config->workload.kind], config->workload.size);
+        scanf("%ld", &size);
+        if (size < 0) {
+            printf("Invalid workload size.\n");
+            exit(1);
+        }
+        if (size > 0) {
+            config->workload.size = size;
+        }
+    }
+}
+
+// Runs every worker once under config->policy and returns their results, with elapsed times
+// measured from the common start
+static ProcessInfo *run_trial(const BenchConfig *config) {
+    ProcessInfo *pInfoArray = calloc(config->num_workers, sizeof(ProcessInfo));
+    SharedResults *shared = shared_results_create(config->num_workers);
+    if (pInfoArray == NULL) {
+        perror("Result allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    if (config->mode == MODE_THREAD) {
+        run_threads(config, shared);
+    }
+    else {
+        // Forked workers inherit unflushed stdio buffers
+        fflush(stdout);
+        fflush(stderr);
+        run_processes(config, shared);
+    }
+
+    // The first worker to run after the barrier marks the common start time
+    long long release_ns = shared->slots[0].info.start_ns;
+    for(int i = 0; i < config->num_workers; i++) {
+        if (!shared->slots[i].valid) {
+            fprintf(stderr, "Worker %d exited without reporting its results\n", i);
+            exit(EXIT_FAILURE);
+        }
+        pInfoArray[i] = shared->slots[i].info;
+        if (pInfoArray[i].start_ns < release_ns) {
+            release_ns = pInfoArray[i].start_ns;
+        }
+    }
+    for(int i = 0; i < config->num_workers; i++) {
+        pInfoArray[i].elapsed_seconds = (pInfoArray[i].end_ns - release_ns) / 1e9;
+    }
+    shared_results_destroy(shared, config->num_workers);
+
+    if(config->policy == POLICY_CFS_NICE) {
+        qsort(pInfoArray, config->num_workers, sizeof(ProcessInfo), compare_nice);
+    }
+    return pInfoArray;
+}
+
+// Prints one trial; the per-worker lines are only shown for a single-trial run
+static void print_trial(const BenchConfig *config, const ProcessInfo *pInfoArray, const char *label, int show_workers) {
+    double total_elapsed_time = 0, total_cpu_time = 0, total_run_delay = 0;
+    long total_voluntary = 0, total_involuntary = 0;
+    long long total_cycles = 0, total_instructions = 0;
+    long total_migrations = 0;
+    int refused = 0, refused_errno = 0;
+    cpu_set_t cpus_used;
+    char cpu_text[256];
+
+    CPU_ZERO(&cpus_used);
+
+    // Start and end times are printed relative to the barrier release
+    long long release_ns = pInfoArray[0].start_ns, last_start_ns = pInfoArray[0].start_ns;
+    for(int i = 1; i < config->num_workers; i++) {
+        if (pInfoArray[i].start_ns < release_ns) {
+            release_ns = pInfoArray[i].start_ns;
+        }
+        if (pInfoArray[i].start_ns > last_start_ns) {
+            last_start_ns = pInfoArray[i].start_ns;
+        }
+    }
+
+    for(int i = 0; i < config->num_workers; i++) {
+    const ProcessInfo *pInfo = &pInfoArray[i];
+
+    total_elapsed_time += pInfo->elapsed_seconds;
+    total_cpu_time += pInfo->user_seconds + pInfo->system_seconds;
+    total_run_delay += pInfo->run_delay_ns > 0 ? pInfo->run_delay_ns / 1e9 : 0.0;
+    total_voluntary += pInfo->voluntary_switches;
+    total_involuntary += pInfo->involuntary_switches;
+    total_cycles += pInfo->cycles > 0 ? pInfo->cycles : 0;
+    total_instructions += pInfo->instructions > 0 ? pInfo->instructions : 0;
+    total_migrations += pInfo->migrations > 0 ? pInfo->migrations : 0;
+    if (pInfo->policy_errno != 0) {
+        refused++;
+        refused_errno = pInfo->policy_errno;
+    }
+    if (pInfo->start_cpu >= 0 && pInfo->end_cpu >= 0) {
+        CPU_SET(pInfo->start_cpu, &cpus_used);
+        CPU_SET(pInfo->end_cpu, &cpus_used);
+    }
+
+    if (!show_workers) {
+        continue;
+    }
+    printf("%s: %d", config->mode == MODE_THREAD ? "TID" : "PID", pInfo->pid);
+    if (config->policy == POLICY_MIXED) {
+        printf(" | Class: %s", policy_names[pInfo->policy]);
+    }
+    // Print Nice value only for the CFS classes
+    if (pInfo->policy == POLICY_CFS_DEFAULT || pInfo->policy == POLICY_CFS_NICE || pInfo->policy == POLICY_BATCH) {
+        printf(" | Nice: %d", pInfo->nice_value);
+    }
+    if (pInfo->policy_errno != 0) {
+        printf(" | Policy not applied: %s", strerror(pInfo->policy_errno));
+    }
+    printf(" | Start: +%.6f | End: +%.6f | Elapsed time: %.6f | User: %.6f | Sys: %.6f | CSW: %ld/%ld",
+        (pInfo->start_ns - release_ns) / 1e9,
+        (pInfo->end_ns - release_ns) / 1e9,
+        pInfo->elapsed_seconds,
+        pInfo->user_seconds,
+        pInfo->system_seconds,
+        pInfo->voluntary_switches,
+        pInfo->involuntary_switches);
+    if (pInfo->run_delay_ns >= 0) {
+        printf(" | Run delay: %.6f", pInfo->run_delay_ns / 1e9);
+    }
+    if (pInfo->cycles >= 0) {
+        printf(" | Cycles: %lld | IPC: %.3f", pInfo->cycles, pInfo->cycles > 0 ? (double)pInfo->instructions / pInfo->cycles : 0.0);
+    }
+    printf(" | CPU: %d->%d", pInfo->start_cpu, pInfo->end_cpu);
+    if (pInfo->migrations >= 0) {
+        printf(" (%ld migrations)", pInfo->migrations);
+    }
+    if (pInfo->node >= 0) {
+        printf(" | Node: %d", pInfo->node);
+    }
+    printf("\n");
+}
+
+    if (refused > 0) {
+        printf("%sWarning: %d of %d workers kept the default policy (%s)\n", label, refused, config->num_workers,
+               strerror(refused_errno));
+    }
+    printf("%sScheduling Policy: %s", label, policy_names[config->policy]);
+    // Print the chosen time quantum for RT_RR
+    if (config->policy == POLICY_RT_RR && config->time_quantum > 0) {
+        printf(" | Time Quantum: %d ms", config->time_quantum);
+    }
+    if (config->policy == POLICY_DEADLINE) {
+        printf(" | Runtime/Deadline/Period: %llu/%llu/%llu us", config->deadline.runtime_ns / 1000,
+               config->deadline.deadline_ns / 1000, config->deadline.period_ns / 1000);
+    }
+    printf(" | Mode: %s | Workers: %d", config->mode == MODE_THREAD ? "threads" : "processes", config->num_workers);
+    printf(" | Workload: %s", workload_names[config->workload.kind]);
+    if (config->workload.kind != WORKLOAD_MATRIX) {
+        printf(" (size %ld %s, %d passes)", config->workload.size, workload_units[config->workload.kind], config->workload.repeat);
+    }
+    printf(" | Average elapsed time: %.6lf | Last start after release: %.6f\n", total_elapsed_time / config->num_workers,
+        (last_start_ns - release_ns) / 1e9);
+    // Elapsed time splits into CPU time, run-queue wait and time spent blocked
+    printf("%sAverage CPU time: %.6f | Average run delay: %.6f%s | Context switches: %ld voluntary, %ld involuntary", label,
+        total_cpu_time / config->num_workers,
+        total_run_delay / config->num_workers,
+        pInfoArray[0].run_delay_ns < 0 ? " (schedstat unavailable)" : "",
+        total_voluntary, total_involuntary);
+    if (total_cycles > 0) {
+        printf(" | IPC: %.3f\n", (double)total_instructions / total_cycles);
+    }
+    else {
+        printf(" | IPC: n/a (perf events unavailable)\n");
+    }
+    // CPUs seen at each worker's start and end; migrations in between may have touched others
+    format_cpuset(&cpus_used, cpu_text, sizeof(cpu_text));
+    printf("%sAffinity: %s", label, placement_names[config->placement]);
+    if (config->worker_cpus != NULL && config->placement != PLACEMENT_NUMA) {
+        char allowed_text[256];
+        format_cpuset(&config->worker_cpus[0], allowed_text, sizeof(allowed_text));
+        printf(" (CPUs %s)", allowed_text);
+    }
+    printf(" | CPUs used: %s (%d) | Migrations: %ld%s\n", cpu_text, CPU_COUNT(&cpus_used), total_migrations,
+        pInfoArray[0].migrations < 0 ? " (unavailable)" : "");
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of a sorted array
+static double percentile(const double *sorted, int count, double p) {
+    int rank = (int)ceil(p / 100.0 * count);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+// Two-sided 95% Student t critical values for 1-30 degrees of freedom
+static double t_critical_95(int df) {
+    static const double table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    return df <= 30 ? table[df - 1] : 1.960;
+}
+
+// Jain's fairness index (sum x)^2 / (n * sum x^2) over worker throughput 1 / elapsed
+static double jain_fairness(const ProcessInfo *pInfoArray, int count) {
+    double sum = 0, sum_squares = 0;
+    for(int i = 0; i < count; i++) {
+        double throughput = pInfoArray[i].elapsed_seconds > 0 ? 1.0 / pInfoArray[i].elapsed_seconds : 0.0;
+        sum += throughput;
+        sum_squares += throughput * throughput;
+    }
+    return sum_squares > 0 ? sum * sum / (count * sum_squares) : 1.0;
+}
+
+// Covers workers [first, first + num_workers) of every trial, which is one group of a mixed run
+static void compute_stats(PolicyStats *stats, ProcessInfo **trials, int trial_count, int first, int num_workers) {
+    int samples = trial_count * num_workers;
+    double *elapsed = malloc(samples * sizeof(double));
+    double sum = 0, sum_squares = 0, mean_sum = 0, mean_squares = 0, cpu = 0, run_delay = 0;
+    int have_run_delay = 1;
+
+    if (elapsed == NULL) {
+        perror("Statistics allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    stats->trials = trial_count;
+    stats->samples = samples;
+    stats->fairness = 0;
+    stats->refused = 0;
+    for(int t = 0; t < trial_count; t++) {
+        double trial_sum = 0;
+        for(int i = 0; i < num_workers; i++) {
+            const ProcessInfo *pInfo = &trials[t][first + i];
+            elapsed[t * num_workers + i] = pInfo->elapsed_seconds;
+            trial_sum += pInfo->elapsed_seconds;
+            sum_squares += pInfo->elapsed_seconds * pInfo->elapsed_seconds;
+            cpu += pInfo->user_seconds + pInfo->system_seconds;
+            run_delay += pInfo->run_delay_ns / 1e9;
+            have_run_delay &= pInfo->run_delay_ns >= 0;
+            stats->refused += pInfo->policy_errno != 0;
+        }
+        sum += trial_sum;
+        mean_sum += trial_sum / num_workers;
+        mean_squares += (trial_sum / num_workers) * (trial_sum / num_workers);
+        stats->fairness += jain_fairness(trials[t] + first, num_workers) / trial_count;
+    }
+
+    qsort(elapsed, samples, sizeof(double), compare_double);
+    stats->mean = sum / samples;
+    stats->stddev = samples > 1 ? sqrt(fmax(0.0, (sum_squares - samples * stats->mean * stats->mean) / (samples - 1))) : 0.0;
+    stats->p50 = percentile(elapsed, samples, 50);
+    stats->p90 = percentile(elapsed, samples, 90);
+    stats->p99 = percentile(elapsed, samples, 99);
+    stats->max = elapsed[samples - 1];
+    stats->cpu_seconds = cpu / samples;
+    stats->run_delay_seconds = have_run_delay ? run_delay / samples : -1;
+
+    // Workers in one trial share the machine and are not independent; the trial means are
+    stats->ci_low = stats->ci_high = stats->mean;
+    if (trial_count > 1) {
+        double trial_mean = mean_sum / trial_count;
+        double variance = fmax(0.0, (mean_squares - trial_count * trial_mean * trial_mean) / (trial_count - 1));
+        double half_width = t_critical_95(trial_count - 1) * sqrt(variance / trial_count);
+        stats->ci_low = trial_mean - half_width;
+        stats->ci_high = trial_mean + half_width;
+    }
+    free(elapsed);
+}
+
+static void print_stats(const PolicyStats *stats, int count) {
+    printf("\n%-24s %6s %7s %10s %10s %10s %10s %10s %10s %23s %8s\n", "Policy", "Trials", "Samples", "Mean", "Stddev",
+           "p50", "p90", "p99", "Max", "95% CI of mean", "Jain");
+    for(int i = 0; i < count; i++) {
+        printf("%-24s %6d %7d %10.6f %10.6f %10.6f %10.6f %10.6f %10.6f  [%9.6f, %9.6f] %8.4f\n",
+               stats[i].label, stats[i].trials, stats[i].samples, stats[i].mean, stats[i].stddev,
+               stats[i].p50, stats[i].p90, stats[i].p99, stats[i].max, stats[i].ci_low, stats[i].ci_high, stats[i].fairness);
+    }
+    for(int i = 0; i < count; i++) {
+        if (stats[i].refused > 0) {
+            printf("Warning: in %d of %d samples of %s the worker kept the default policy\n", stats[i].refused,
+                   stats[i].samples, stats[i].label);
+        }
+    }
+}
+
+// Wakeup latency per policy, with a log2 histogram so the tail is visible next to the median
+static void print_latency_stats(const PolicyStats *stats, int count) {
+    printf("\n%-24s %10s %9s %9s %9s %9s %9s %9s\n", "Wakeup latency (us)", "Samples", "Min", "Avg", "p50", "p99", "p99.9", "Max");
+    for(int i = 0; i < count; i++) {
+        const LatencyHistogram *h = stats[i].latency;
+        printf("%-24s %10lld %9.1f %9.1f %9.0f %9.0f %9.0f %9.1f\n", stats[i].label, h->samples, h->min_ns / 1000.0,
+               h->samples ? h->sum_ns / 1000.0 / h->samples : 0.0, latency_percentile(h, 50), latency_percentile(h, 99),
+               latency_percentile(h, 99.9), h->max_ns / 1000.0);
+    }
+
+    printf("\n%-24s", "Histogram (us)");
+    for(int i = 0; i < count; i++) {
+        printf(" %12.12s", stats[i].label);
+    }
+    printf("\n");
+    for(int row = 0; row < LATENCY_LOG_BUCKETS; row++) {
+        int last = row == LATENCY_LOG_BUCKETS - 1;
+        long long low = row == 0 ? 0 : 1LL << (row - 1), high = last ? LATENCY_HISTOGRAM_US : 1LL << row; // bucket b holds [b, b + 1) usec
+        char range[32];
+        if (last) {
+            snprintf(range, sizeof(range), "> %lld", low);
+        }
+        else {
+            snprintf(range, sizeof(range), "<= %lld", high);
+        }
+        printf("%-24s", range);
+        for(int i = 0; i < count; i++) {
+            const LatencyHistogram *h = stats[i].latency;
+            long long n = last ? h->overflow : 0;
+            for(long long b = low; b < high; b++) {
+                n += h->buckets[b];
+            }
+            printf(" %12lld", n);
+        }
+        printf("\n");
+    }
+}
+
+// cyclictest-style histogram: one row per 1 usec bucket that any policy hit, one column per policy
+static int write_histogram(const char *path, const PolicyStats *stats, int count) {
+    FILE *fp = fopen(path, "w");
+
+    if (fp == NULL) {
+        perror("Failed to open the histogram file");
+        return -1;
+    }
+    fprintf(fp, "# Wakeup latency histogram, 1 usec buckets\n# usec");
+    for(int i = 0; i < count; i++) {
+        fprintf(fp, " %s", stats[i].label);
+    }
+    fprintf(fp, "\n");
+    for(int b = 0; b < LATENCY_HISTOGRAM_US; b++) {
+        int used = 0;
+        for(int i = 0; i < count; i++) {
+            used |= stats[i].latency->buckets[b] != 0;
+        }
+        if (!used) {
+            continue;
+        }
+        fprintf(fp, "%06d", b);
+        for(int i = 0; i < count; i++) {
+            fprintf(fp, " %06lld", stats[i].latency->buckets[b]);
+        }
+        fprintf(fp, "\n");
+    }
+    fprintf(fp, "# Total:");
+    for(int i = 0; i < count; i++) {
+        fprintf(fp, " %09lld", stats[i].latency->samples);
+    }
+    fprintf(fp, "\n# Min Latencies:");
+    for(int i = 0; i < count; i++) {
+        fprintf(fp, " %05lld", stats[i].latency->min_ns / 1000);
+    }
+    fprintf(fp, "\n# Avg Latencies:");
+    for(int i = 0; i < count; i++) {
+        fprintf(fp, " %05lld", stats[i].latency->samples ? stats[i].latency->sum_ns / 1000 / stats[i].latency->samples : 0);
+    }
+    fprintf(fp, "\n# Max Latencies:");
+    for(int i = 0; i < count; i++) {
+        fprintf(fp, " %05lld", stats[i].latency->max_ns / 1000);
+    }
+    fprintf(fp, "\n# Histogram Overflows:");
+    for(int i = 0; i < count; i++) {
+        fprintf(fp, " %05lld", stats[i].latency->overflow);
+    }
+    fprintf(fp, "\n");
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+// Writes one record per policy, with the run parameters and kernel release repeated in every
+// record so exports from different machines or kernels can be diffed directly
+static int export_stats(const BenchConfig *config, const PolicyStats *stats, int count) {
+    FILE *fp = fopen(config->export_path, "w");
+    struct utsname host;
+
+    if (fp == NULL) {
+        perror("Failed to open the output file");
+        return -1;
+    }
+    if (uname(&host) == -1) {
+        snprintf(host.release, sizeof(host.release), "unknown");
+    }
+
+    if (config->export_format == EXPORT_CSV) {
+        fprintf(fp, "kernel,policy,time_quantum_ms,mode,affinity,workers,workload,size,repeat,warmup,trials,samples,"
+                    "mean_s,stddev_s,p50_s,p90_s,p99_s,max_s,ci95_low_s,ci95_high_s,jain_fairness,cpu_s,run_delay_s,refused_samples%s\n",
+                    config->latency_threads > 0 ? ",latency_samples,latency_min_us,latency_avg_us,latency_p99_us,latency_max_us" : "");
+    }
+    else {
+        fprintf(fp, "[\n");
+    }
+
+    for(int i = 0; i < count; i++) {
+        const PolicyStats *st = &stats[i];
+        int quantum = st->policy == POLICY_RT_RR ? config->time_quantum : 0;
+        const char *mode = config->mode == MODE_THREAD ? "thread" : "process";
+        char affinity[32];
+
+        if (config->placement_arg >= 0) {
+            snprintf(affinity, sizeof(affinity), "%s:%d", placement_names[config->placement], config->placement_arg);
+        }
+        else {
+            snprintf(affinity, sizeof(affinity), "%s", placement_names[config->placement]);
+        }
+
+        if (config->export_format == EXPORT_CSV) {
+            fprintf(fp, "%s,%s,%d,%s,%s,%d,%s,%ld,%d,%d,%d,%d,%.9f,%.9f,%.9f,%.9f,%.9f,%.9f,%.9f,%.9f,%.6f,%.9f,%.9f,%d",
+                    host.release, st->label, quantum, mode, affinity, config->num_workers,
+                    workload_names[config->workload.kind], config->workload.size, config->workload.repeat,
+                    config->warmup, st->trials, st->samples, st->mean, st->stddev, st->p50, st->p90, st->p99, st->max,
+                    st->ci_low, st->ci_high, st->fairness, st->cpu_seconds, st->run_delay_seconds, st->refused);
+            if (st->latency != NULL) {
+                fprintf(fp, ",%lld,%.3f,%.3f,%.0f,%.3f", st->latency->samples, st->latency->min_ns / 1000.0,
+                        st->latency->samples ? st->latency->sum_ns / 1000.0 / st->latency->samples : 0.0,
+                        latency_percentile(st->latency, 99), st->latency->max_ns / 1000.0);
+            }
+            fprintf(fp, "\n");
+        }
+        else {
+            fprintf(fp, "  {\"kernel\": \"%s\", \"policy\": \"%s\", \"time_quantum_ms\": %d, \"mode\": \"%s\", \"affinity\": \"%s\", \"workers\": %d, "
+                        "\"workload\": \"%s\", \"size\": %ld, \"repeat\": %d, \"warmup\": %d, \"trials\": %d, \"samples\": %d, "
+                        "\"mean_s\": %.9f, \"stddev_s\": %.9f, \"p50_s\": %.9f, \"p90_s\": %.9f, \"p99_s\": %.9f, \"max_s\": %.9f, "
+                        "\"ci95_s\": [%.9f, %.9f], \"jain_fairness\": %.6f, \"cpu_s\": %.9f, \"run_delay_s\": ",
+                    host.release, st->label, quantum, mode, affinity, config->num_workers,
+                    workload_names[config->workload.kind], config->workload.size, config->workload.repeat,
+                    config->warmup, st->trials, st->samples, st->mean, st->stddev, st->p50, st->p90, st->p99, st->max,
+                    st->ci_low, st->ci_high, st->fairness, st->cpu_seconds);
+            if (st->run_delay_seconds >= 0) {
+                fprintf(fp, "%.9f", st->run_delay_seconds);
+            }
+            else {
+                fprintf(fp, "null");
+            }
+            fprintf(fp, ", \"refused_samples\": %d", st->refused);
+            if (st->latency != NULL) {
+                fprintf(fp, ", \"latency_samples\": %lld, \"latency_min_us\": %.3f, \"latency_avg_us\": %.3f, "
+                            "\"latency_p99_us\": %.0f, \"latency_max_us\": %.3f", st->latency->samples, st->latency->min_ns / 1000.0,
+                        st->latency->samples ? st->latency->sum_ns / 1000.0 / st->latency->samples : 0.0,
+                        latency_percentile(st->latency, 99), st->latency->max_ns / 1000.0);
+            }
+            fprintf(fp, "}%s\n", i + 1 < count ? "," : "");
+        }
+    }
+
+    if (config->export_format == EXPORT_JSON) {
+        fprintf(fp, "]\n");
+    }
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+int main(int argc, char *argv[]) {
+    BenchConfig config = {
+        .policy = POLICY_CFS_DEFAULT,
+        .policies = { POLICY_CFS_DEFAULT },
+        .policy_count = 1,
+        .trials = 1,
+        .warmup = 0,
+        .export_format = EXPORT_NONE,
+        .num_workers = NUM_PROCESSES,
+        .mode = MODE_PROCESS,
+        .workload = workload_defaults[WORKLOAD_MATRIX],
+        .nice_groups = { { -20, 0 }, { 0, 0 }, { 19, 0 } },
+        .nice_group_count = 3,
+        .placement = PLACEMENT_FREE,
+        .placement_arg = -1,
+        .deadline = { POLICY_DEADLINE, 1, 0, 0, DEADLINE_DEFAULT_RUNTIME_US * 1000ULL,
+                      DEADLINE_DEFAULT_PERIOD_US * 1000ULL, DEADLINE_DEFAULT_PERIOD_US * 1000ULL },
+        .latency_interval_us = LATENCY_DEFAULT_INTERVAL_US
+    };
+    atomic_int timers_stop;
+    LatencyHistogram *trial_latency = NULL;
+    PolicyStats stats[POLICY_COUNT + MAX_CLASSES];
+    int stats_count = 0;
+
+    if (argc > 1) {
+        if (parse_command_line(argc, argv, &config) == -1) {
+            return 1;
+        }
+    }
+    else {
+        read_interactive_config(&config);
+    }
+    if (resolve_nice_groups(&config) == -1 || plan_placement(&config) == -1) {
+        return 1;
+    }
+
+    // Set the time quantum for RT_RR before starting the workers
+    int uses_rr = 0;
+    for(int p = 0; p < config.policy_count; p++) {
+        uses_rr |= config.policies[p] == POLICY_RT_RR;
+    }
+    for(int g = 0; g < config.class_count; g++) {
+        uses_rr |= config.classes[g].policy == POLICY_RT_RR;
+    }
+    if (uses_rr && config.time_quantum > 0) {
+        FILE *fp = fopen("/proc/sys/kernel/sched_rr_timeslice_ms", "w");
+        if (fp == NULL) {
+            perror("Failed to open sched_rr_timeslice_ms");
+            exit(1);
+        }
+        fprintf(fp, "%d", config.time_quantum);
+        fclose(fp);
+    }
+
+    int rounds = config.warmup + config.trials;
+    int single_run = rounds == 1;
+    ProcessInfo **trials = malloc(config.trials * sizeof(ProcessInfo *));
+    if (config.latency_threads > 0) {
+        trial_latency = malloc(sizeof(LatencyHistogram));
+        config.latency_window = mmap(NULL, sizeof(LatencyWindow), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (config.latency_window == MAP_FAILED) {
+            perror("Shared result mapping failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (trials == NULL || (config.latency_threads > 0 && trial_latency == NULL)) {
+        perror("Result allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    for(int p = 0; p < config.policy_count; p++) {
+        LatencyHistogram *policy_latency = NULL;
+        // In latency mode the policy under test belongs to the timer threads and the workers are CFS load
+        BenchConfig load = config;
+
+        config.policy = config.policies[p];
+        load.policy = config.latency_threads > 0 ? POLICY_CFS_DEFAULT : config.policy;
+        if (config.latency_threads > 0) {
+            policy_latency = malloc(sizeof(LatencyHistogram));
+            if (policy_latency == NULL) {
+                perror("Result allocation failed");
+                exit(EXIT_FAILURE);
+            }
+            latency_reset(policy_latency);
+        }
+
+        for(int round = 0; round < rounds; round++) {
+            char label[64] = "";
+            TimerThread *timers = NULL;
+
+            if (!single_run) {
+                if (round < config.warmup) {
+                    snprintf(label, sizeof(label), "[warm-up %d/%d] ", round + 1, config.warmup);
+                }
+                else {
+                    snprintf(label, sizeof(label), "[trial %d/%d] ", round - config.warmup + 1, config.trials);
+                }
+            }
+
+            if (config.latency_threads > 0) {
+                timers = start_timer_threads(&config, &timers_stop);
+            }
+            ProcessInfo *pInfoArray = run_trial(&load);
+            print_trial(&load, pInfoArray, label, single_run);
+            if (timers != NULL) {
+                stop_timer_threads(&config, timers, &timers_stop, trial_latency, label);
+                if (round >= config.warmup) {
+                    latency_merge(policy_latency, trial_latency);
+                }
+            }
+
+            if (round < config.warmup) {
+                free(pInfoArray);
+            }
+            else {
+                trials[round - config.warmup] = pInfoArray;
+            }
+        }
+
+        if (config.policy == POLICY_MIXED) {
+            // One row per group, so the interference between classes shows side by side
+            for(int g = 0, first = 0; g < config.class_count; first += config.classes[g++].count) {
+                PolicyStats *st = &stats[stats_count++];
+                st->latency = NULL;
+                st->policy = config.classes[g].policy;
+                snprintf(st->label, sizeof(st->label), "MIXED/%s:%d", policy_options[st->policy], config.classes[g].count);
+                compute_stats(st, trials, config.trials, first, config.classes[g].count);
+            }
+        }
+        else {
+            PolicyStats *st = &stats[stats_count++];
+            st->policy = config.policy;
+            snprintf(st->label, sizeof(st->label), "%s", policy_names[config.policy]);
+            compute_stats(st, trials, config.trials, 0, config.num_workers);
+            st->latency = policy_latency;
+        }
+        for(int t = 0; t < config.trials; t++) {
+            free(trials[t]);
+        }
+    }
+    free(trials);
+    free(trial_latency);
+    free(config.worker_cpus);
+    free(config.worker_nodes);
+    if (config.latency_window != NULL) {
+        munmap(config.latency_window, sizeof(LatencyWindow));
+    }
+
+    if (!single_run || stats_count > 1) {
+        print_stats(stats, stats_count);
+    }
+    if (config.latency_threads > 0) {
+        print_latency_stats(stats, stats_count);
+    }
+    int status = 0;
+    if (config.export_path != NULL && export_stats(&config, stats, stats_count) == -1) {
+        status = 1;
+    }
+    if (config.histogram_path != NULL && write_histogram(config.histogram_path, stats, stats_count) == -1) {
+        status = 1;
+    }
+    for(int i = 0; i < stats_count; i++) {
+        free(stats[i].latency);
+    }
+    return status;
+}